@@ -0,0 +1,91 @@
+#pragma once
+
+// Qt
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+class QStyleSyntaxHighlighter;
+
+/**
+ * @brief Class, that runs QCodeEditor benchmarks
+ * and collects results into JSON object.
+ */
+class BenchmarkRunner
+{
+public:
+
+    /**
+     * @brief Constructor.
+     * @param maxSize Maximal size of generated
+     * samples in bytes.
+     */
+    explicit BenchmarkRunner(int maxSize);
+
+    /**
+     * @brief Method for running all benchmarks.
+     * @param result Results.
+     * @return Are all benchmarks finished.
+     */
+    bool run(QJsonObject& result);
+
+    /**
+     * @brief Method for getting description of
+     * error, that stopped benchmarks.
+     */
+    QString errorString() const;
+
+private:
+
+    /**
+     * @brief Method for measuring full document
+     * highlighting throughput of every highlighter
+     * on every sample size.
+     */
+    QJsonArray runHighlighting();
+
+    /**
+     * @brief Method for measuring time from attaching
+     * lazy highlighter to editor till first painted
+     * frame and time of highlighting document again
+     * on every sample size. It shouldn't depend on
+     * number of blocks.
+     */
+    QJsonArray runFirstPaint();
+
+    /**
+     * @brief Method for measuring time from key press
+     * till repainted editor.
+     */
+    QJsonObject runKeystrokes();
+
+    /**
+     * @brief Method for measuring time of painting
+     * editor after scrolling by page.
+     */
+    QJsonObject runScrolling();
+
+    /**
+     * @brief Method for measuring time of switching
+     * syntax style of editor.
+     * @param result Results.
+     * @return Is second style loaded.
+     */
+    bool runStyleSwitch(QJsonObject& result);
+
+    /**
+     * @brief Static method for creating highlighter
+     * by language name.
+     */
+    static QStyleSyntaxHighlighter* createHighlighter(const QString& language);
+
+    /**
+     * @brief Static method for converting durations
+     * in milliseconds into JSON statistics.
+     */
+    static QJsonObject statistics(QVector<double> durations);
+
+    int m_maxSize;
+    QString m_errorString;
+};
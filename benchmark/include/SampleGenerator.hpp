@@ -0,0 +1,31 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Class, that generates source code samples
+ * of requested size for highlighting benchmarks.
+ */
+class SampleGenerator
+{
+public:
+
+    /**
+     * @brief Static method for getting names of
+     * languages, that have sample.
+     */
+    static QStringList languages();
+
+    /**
+     * @brief Static method for generating sample. Sample
+     * is built from snippet, repeated with different
+     * identifiers until size is reached.
+     * @param language Language name from `languages`.
+     * @param size Sample size in bytes.
+     * @return Sample or empty string if language
+     * is unknown.
+     */
+    static QString generate(const QString& language, int size);
+};
@@ -0,0 +1,331 @@
+// Bench
+#include <BenchmarkRunner.hpp>
+#include <SampleGenerator.hpp>
+
+// QCodeEditor
+#include <QCodeEditor>
+#include <QSyntaxStyle>
+#include <QCXXHighlighter>
+#include <QGLSLHighlighter>
+#include <QXMLHighlighter>
+#include <QJSONHighlighter>
+#include <QLuaHighlighter>
+#include <QPythonHighlighter>
+
+// Qt
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QKeyEvent>
+#include <QScrollBar>
+#include <QTextDocument>
+
+// std
+#include <algorithm>
+
+// Sample sizes from 1 KB to 50 MB
+static const int sampleSizes[] = {
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+    50000000
+};
+
+// Size of document for editor benchmarks
+static const int editorSampleSize = 1000000;
+
+static const int keystrokes = 100;
+static const int scrollSteps = 100;
+static const int styleSwitches = 10;
+
+BenchmarkRunner::BenchmarkRunner(int maxSize) :
+    m_maxSize(maxSize),
+    m_errorString()
+{
+
+}
+
+bool BenchmarkRunner::run(QJsonObject& result)
+{
+    result["qtVersion"] = QString(qVersion());
+    result["platform"] = QApplication::platformName();
+    result["highlighting"] = runHighlighting();
+    result["firstPaint"] = runFirstPaint();
+    result["keystrokes"] = runKeystrokes();
+    result["scrolling"] = runScrolling();
+
+    QJsonObject styleSwitch;
+
+    if (!runStyleSwitch(styleSwitch))
+    {
+        return false;
+    }
+
+    result["styleSwitch"] = styleSwitch;
+
+    return true;
+}
+
+QString BenchmarkRunner::errorString() const
+{
+    return m_errorString;
+}
+
+QJsonArray BenchmarkRunner::runHighlighting()
+{
+    QJsonArray results;
+
+    for (auto&& language : SampleGenerator::languages())
+    {
+        for (auto size : sampleSizes)
+        {
+            if (size > m_maxSize)
+            {
+                break;
+            }
+
+            QTextDocument document;
+            document.setPlainText(SampleGenerator::generate(language, size));
+
+            auto highlighter = createHighlighter(language);
+            highlighter->setSyntaxStyle(QSyntaxStyle::defaultStyle());
+            highlighter->setDocument(&document);
+
+            QElapsedTimer timer;
+            timer.start();
+
+            highlighter->rehighlight();
+
+            auto seconds = timer.nsecsElapsed() / 1e9;
+
+            delete highlighter;
+
+            QJsonObject entry;
+            entry["highlighter"] = language;
+            entry["bytes"] = size;
+            entry["blocks"] = document.blockCount();
+            entry["seconds"] = seconds;
+            entry["megabytesPerSecond"] = size / 1e6 / seconds;
+
+            results.append(entry);
+        }
+    }
+
+    return results;
+}
+
+QJsonArray BenchmarkRunner::runFirstPaint()
+{
+    QJsonArray results;
+
+    for (auto size : sampleSizes)
+    {
+        if (size > m_maxSize)
+        {
+            break;
+        }
+
+        QCodeEditor editor;
+        QCXXHighlighter highlighter;
+        highlighter.setHighlightMode(QStyleSyntaxHighlighter::HighlightMode::Lazy);
+
+        editor.resize(1280, 1024);
+        editor.setPlainText(SampleGenerator::generate("CXX", size));
+        editor.show();
+        QApplication::processEvents();
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // Event loop runs highlighting, that's
+        // posted, when document is attached
+        editor.setHighlighter(&highlighter);
+        QApplication::processEvents();
+        editor.repaint();
+
+        auto attachMilliseconds = timer.nsecsElapsed() / 1e6;
+
+        timer.restart();
+
+        highlighter.rehighlight();
+        editor.repaint();
+
+        auto rehighlightMilliseconds = timer.nsecsElapsed() / 1e6;
+
+        editor.setHighlighter(nullptr);
+
+        QJsonObject entry;
+        entry["bytes"] = size;
+        entry["blocks"] = editor.document()->blockCount();
+        entry["attachMilliseconds"] = attachMilliseconds;
+        entry["rehighlightMilliseconds"] = rehighlightMilliseconds;
+
+        results.append(entry);
+    }
+
+    return results;
+}
+
+QJsonObject BenchmarkRunner::runKeystrokes()
+{
+    QCodeEditor editor;
+    QCXXHighlighter highlighter;
+
+    editor.resize(1280, 1024);
+    editor.setPlainText(SampleGenerator::generate("CXX", qMin(editorSampleSize, m_maxSize)));
+    editor.setHighlighter(&highlighter);
+    editor.show();
+    QApplication::processEvents();
+
+    // Typing in the middle of document
+    auto cursor = editor.textCursor();
+    cursor.setPosition(editor.document()->characterCount() / 2);
+    editor.setTextCursor(cursor);
+    editor.ensureCursorVisible();
+    QApplication::processEvents();
+
+    QVector<double> durations;
+
+    for (int i = 0; i < keystrokes; ++i)
+    {
+        auto key = Qt::Key_A + (i % 26);
+        QKeyEvent event(QEvent::KeyPress, key, Qt::NoModifier, QString(QChar('a' + i % 26)));
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QApplication::sendEvent(&editor, &event);
+        QApplication::processEvents();
+        editor.repaint();
+
+        durations.append(timer.nsecsElapsed() / 1e6);
+    }
+
+    editor.setHighlighter(nullptr);
+
+    return statistics(durations);
+}
+
+QJsonObject BenchmarkRunner::runScrolling()
+{
+    QCodeEditor editor;
+    QCXXHighlighter highlighter;
+
+    editor.resize(1280, 1024);
+    editor.setPlainText(SampleGenerator::generate("CXX", qMin(editorSampleSize, m_maxSize)));
+    editor.setHighlighter(&highlighter);
+    editor.show();
+    QApplication::processEvents();
+
+    auto scrollBar = editor.verticalScrollBar();
+
+    QVector<double> durations;
+
+    for (int i = 0; i < scrollSteps; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        scrollBar->setValue(scrollBar->value() + scrollBar->pageStep());
+        editor.repaint();
+
+        durations.append(timer.nsecsElapsed() / 1e6);
+    }
+
+    editor.setHighlighter(nullptr);
+
+    return statistics(durations);
+}
+
+bool BenchmarkRunner::runStyleSwitch(QJsonObject& result)
+{
+    // Second style with the same properties. Default
+    // style also initializes library resources.
+    QSyntaxStyle::defaultStyle();
+
+    QFile fl(":/default_style.xml");
+
+    if (!fl.open(QIODevice::ReadOnly))
+    {
+        m_errorString = "Can't open " + fl.fileName();
+        return false;
+    }
+
+    QSyntaxStyle style;
+    style.load(fl.readAll());
+
+    QCodeEditor editor;
+    QCXXHighlighter highlighter;
+
+    editor.resize(1280, 1024);
+    editor.setPlainText(SampleGenerator::generate("CXX", qMin(editorSampleSize, m_maxSize)));
+    editor.setHighlighter(&highlighter);
+    editor.show();
+    QApplication::processEvents();
+
+    QVector<double> durations;
+
+    for (int i = 0; i < styleSwitches; ++i)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        editor.setSyntaxStyle(i % 2 ? QSyntaxStyle::defaultStyle() : &style);
+        QApplication::processEvents();
+        editor.repaint();
+
+        durations.append(timer.nsecsElapsed() / 1e6);
+    }
+
+    editor.setHighlighter(nullptr);
+
+    result = statistics(durations);
+
+    return true;
+}
+
+QStyleSyntaxHighlighter* BenchmarkRunner::createHighlighter(const QString& language)
+{
+    if (language == "CXX")    return new QCXXHighlighter;
+    if (language == "GLSL")   return new QGLSLHighlighter;
+    if (language == "XML")    return new QXMLHighlighter;
+    if (language == "JSON")   return new QJSONHighlighter;
+    if (language == "Lua")    return new QLuaHighlighter;
+    if (language == "Python") return new QPythonHighlighter;
+
+    return nullptr;
+}
+
+QJsonObject BenchmarkRunner::statistics(QVector<double> durations)
+{
+    QJsonObject result;
+
+    if (durations.isEmpty())
+    {
+        return result;
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    double sum = 0;
+    for (auto duration : durations)
+    {
+        sum += duration;
+    }
+
+    auto percentile = [&durations](double p)
+    {
+        auto index = static_cast<int>(p * (durations.size() - 1));
+        return durations[index];
+    };
+
+    result["samples"] = durations.size();
+    result["meanMilliseconds"] = sum / durations.size();
+    result["medianMilliseconds"] = percentile(0.5);
+    result["p95Milliseconds"] = percentile(0.95);
+    result["maxMilliseconds"] = durations.last();
+
+    return result;
+}
@@ -0,0 +1,153 @@
+// Bench
+#include <SampleGenerator.hpp>
+
+// Qt
+#include <QMap>
+
+static const QMap<QString, const char*> snippets = {
+    {"CXX", R"(/*
+ * Block comment %1
+ */
+#include <vector>
+#include "module%1.hpp"
+
+namespace sample%1
+{
+    // Line comment
+    static const int value%1 = 0x%1;
+
+    class Item%1 : public Base
+    {
+    public:
+        explicit Item%1(int value) : m_value(value) {}
+
+        double compute(const std::vector<int>& items) const
+        {
+            double result = 0.5;
+            for (auto&& item : items)
+            {
+                result += item * m_value;
+            }
+            return result > 1e3 ? result : -1.0;
+        }
+
+    private:
+        int m_value;
+    };
+}
+
+)"},
+    {"GLSL", R"(#version 330 core
+/* Shader %1 */
+layout(location = 0) in vec3 position%1;
+uniform mat4 transform%1;
+out vec4 color%1;
+
+// Line comment
+float attenuate%1(float distance)
+{
+    return clamp(1.0 / (distance * distance), 0.0, 1.0);
+}
+
+void main()
+{
+    vec4 world = transform%1 * vec4(position%1, 1.0);
+    color%1 = vec4(normalize(world.xyz), attenuate%1(length(world.xyz)));
+    gl_Position = world;
+}
+
+)"},
+    {"XML", R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- Comment %1 -->
+<root id="%1">
+    <item name="first%1" value="1"/>
+    <item name="second%1" value="2">
+        <child enabled="true">Text %1</child>
+    </item>
+    <!-- Multiline
+         comment -->
+    <list>
+        <entry key="a%1">Alpha</entry>
+        <entry key="b%1">Beta</entry>
+    </list>
+</root>
+
+)"},
+    {"JSON", R"({
+    "id": %1,
+    "name": "object%1",
+    "enabled": true,
+    "ratio": 0.%1,
+    "parent": null,
+    "tags": ["first", "second", "third"],
+    "nested": {
+        "key%1": "value",
+        "count": 42
+    }
+},
+)"},
+    {"Lua", R"(--[[ Block comment %1 ]]
+local module%1 = require("module%1")
+
+-- Line comment
+local function compute%1(items, factor)
+    local result = 0.5
+    for index, item in ipairs(items) do
+        if item > factor and not module%1.skip then
+            result = result + item * factor
+        end
+    end
+    return result, "done %1"
+end
+
+return compute%1
+
+)"},
+    {"Python", R"(import module%1
+
+"""
+Docstring %1
+"""
+
+# Line comment
+class Item%1(object):
+    def __init__(self, value):
+        self.value = value
+
+    def compute(self, items):
+        result = 0.5
+        for item in items:
+            if item > self.value and not None:
+                result += item * %1
+        return result, 'done %1'
+
+)"}
+};
+
+QStringList SampleGenerator::languages()
+{
+    return snippets.keys();
+}
+
+QString SampleGenerator::generate(const QString& language, int size)
+{
+    auto snippet = snippets.value(language, nullptr);
+
+    if (snippet == nullptr)
+    {
+        return QString();
+    }
+
+    QString result;
+    result.reserve(size + 1024);
+
+    auto pattern = QString::fromUtf8(snippet);
+    for (int i = 1; result.size() < size; ++i)
+    {
+        result += pattern.arg(i);
+    }
+
+    result.truncate(size);
+
+    return result;
+}
@@ -0,0 +1,72 @@
+// Bench
+#include <BenchmarkRunner.hpp>
+
+// Qt
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+int main(int argc, char** argv)
+{
+    // Running without display by default
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("QCodeEditor benchmark");
+    parser.addHelpOption();
+
+    QCommandLineOption maxSizeOption(
+        "max-size",
+        "Maximal size of generated samples in bytes.",
+        "bytes",
+        "50000000"
+    );
+
+    QCommandLineOption outputOption(
+        "output",
+        "File for JSON results. Standard output by default.",
+        "file"
+    );
+
+    parser.addOption(maxSizeOption);
+    parser.addOption(outputOption);
+    parser.process(a);
+
+    BenchmarkRunner runner(parser.value(maxSizeOption).toInt());
+
+    QJsonObject result;
+
+    if (!runner.run(result))
+    {
+        QTextStream(stderr) << runner.errorString() << "\n";
+        return 1;
+    }
+
+    auto json = QJsonDocument(result).toJson();
+
+    if (!parser.isSet(outputOption))
+    {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+
+    QFile output(parser.value(outputOption));
+
+    if (!output.open(QIODevice::WriteOnly))
+    {
+        QTextStream(stderr) << "Can't open " << output.fileName() << "\n";
+        return 1;
+    }
+
+    output.write(json);
+
+    return 0;
+}
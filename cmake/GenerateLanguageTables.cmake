@@ -0,0 +1,127 @@
+# Script, that compiles language files into constexpr
+# tables of QLanguageTable.
+#
+# Usage:
+#   cmake -DLANGUAGES_DIR=<dir> -DOUTPUT=<file> -P GenerateLanguageTables.cmake
+#
+# Every `<dir>/*.xml` file becomes table with name of
+# file without extension. Files are read the same way
+# as QLanguage reads them: sections are sorted by key,
+# empty sections are skipped.
+
+if (NOT LANGUAGES_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "LANGUAGES_DIR and OUTPUT are required.")
+endif()
+
+file(GLOB LANGUAGE_FILES "${LANGUAGES_DIR}/*.xml")
+list(SORT LANGUAGE_FILES)
+
+set(CONTENT "// Generated by GenerateLanguageTables.cmake from\n")
+string(APPEND CONTENT "// resources/languages. Don't edit.\n\n")
+string(APPEND CONTENT "// QCodeEditor\n#include <QLanguageTable>\n\n")
+string(APPEND CONTENT "namespace\n{\n")
+
+set(TABLES "")
+set(TABLE_COUNT 0)
+
+foreach(LANGUAGE_FILE ${LANGUAGE_FILES})
+    get_filename_component(LANGUAGE ${LANGUAGE_FILE} NAME_WE)
+    string(MAKE_C_IDENTIFIER ${LANGUAGE} LANGUAGE_ID)
+
+    # Characters, that have special meaning in CMake
+    # lists, are replaced with placeholders
+    file(READ ${LANGUAGE_FILE} LINES)
+    string(REPLACE ";" "@SEMICOLON@" LINES "${LINES}")
+    string(REPLACE "[" "@LEFT_BRACKET@" LINES "${LINES}")
+    string(REPLACE "]" "@RIGHT_BRACKET@" LINES "${LINES}")
+    string(REPLACE "\n" ";" LINES "${LINES}")
+
+    set(KEY "")
+    set(KEYS "")
+
+    foreach(LINE IN LISTS LINES)
+        if (LINE MATCHES "<section[ \t]+name=\"([^\"]*)\"")
+            set(KEY ${CMAKE_MATCH_1})
+        endif()
+
+        string(REGEX MATCHALL "<name>[^<]*</name>" NAMES "${LINE}")
+
+        foreach(NAME IN LISTS NAMES)
+            string(REGEX REPLACE "^<name>(.*)</name>$" "\\1" NAME "${NAME}")
+
+            # Placeholders and XML entities
+            string(REPLACE "@SEMICOLON@" ";" NAME "${NAME}")
+            string(REPLACE "@LEFT_BRACKET@" "[" NAME "${NAME}")
+            string(REPLACE "@RIGHT_BRACKET@" "]" NAME "${NAME}")
+            string(REPLACE "&lt;" "<" NAME "${NAME}")
+            string(REPLACE "&gt;" ">" NAME "${NAME}")
+            string(REPLACE "&quot;" "\"" NAME "${NAME}")
+            string(REPLACE "&apos;" "'" NAME "${NAME}")
+            string(REPLACE "&amp;" "&" NAME "${NAME}")
+
+            # C++ string literal
+            string(REPLACE "\\" "\\\\" NAME "${NAME}")
+            string(REPLACE "\"" "\\\"" NAME "${NAME}")
+
+            string(MAKE_C_IDENTIFIER "${KEY}" KEY_ID)
+
+            list(FIND KEYS "${KEY}" KEY_INDEX)
+            if (KEY_INDEX EQUAL -1)
+                list(APPEND KEYS "${KEY}")
+                set(NAMES_${KEY_ID} "")
+                set(COUNT_${KEY_ID} 0)
+            endif()
+
+            string(APPEND NAMES_${KEY_ID} "        \"${NAME}\",\n")
+            math(EXPR COUNT_${KEY_ID} "${COUNT_${KEY_ID}} + 1")
+        endforeach()
+    endforeach()
+
+    list(SORT KEYS)
+    list(LENGTH KEYS SECTION_COUNT)
+
+    set(SECTIONS "")
+
+    foreach(KEY IN LISTS KEYS)
+        string(MAKE_C_IDENTIFIER "${KEY}" KEY_ID)
+
+        string(APPEND CONTENT "    constexpr const char* ${LANGUAGE_ID}_${KEY_ID}[] = {\n")
+        string(APPEND CONTENT "${NAMES_${KEY_ID}}")
+        string(APPEND CONTENT "    };\n\n")
+
+        string(APPEND SECTIONS "        {\"${KEY}\", ${LANGUAGE_ID}_${KEY_ID}, ${COUNT_${KEY_ID}}},\n")
+    endforeach()
+
+    if (SECTION_COUNT EQUAL 0)
+        message(WARNING "${LANGUAGE_FILE} has no names.")
+        continue()
+    endif()
+
+    string(APPEND CONTENT "    constexpr QLanguageTable::Section ${LANGUAGE_ID}_sections[] = {\n")
+    string(APPEND CONTENT "${SECTIONS}")
+    string(APPEND CONTENT "    };\n\n")
+
+    string(APPEND TABLES "    {\"${LANGUAGE}\", ${LANGUAGE_ID}_sections, ${SECTION_COUNT}},\n")
+    math(EXPR TABLE_COUNT "${TABLE_COUNT} + 1")
+endforeach()
+
+string(APPEND CONTENT "}\n\n")
+
+if (TABLE_COUNT EQUAL 0)
+    message(FATAL_ERROR "There are no language files in ${LANGUAGES_DIR}.")
+endif()
+
+string(APPEND CONTENT "const QLanguageTable QLanguageTable::builtin[] = {\n")
+string(APPEND CONTENT "${TABLES}")
+string(APPEND CONTENT "};\n\n")
+string(APPEND CONTENT "const int QLanguageTable::builtinCount = ${TABLE_COUNT};\n")
+
+# Keeping old file, so library isn't rebuilt
+# without changes
+if (EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} OLD_CONTENT)
+endif()
+
+if (NOT "${OLD_CONTENT}" STREQUAL "${CONTENT}")
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
@@ -13,6 +13,7 @@
 #include <QJSONHighlighter>
 #include <QLuaHighlighter>
 #include <QPythonHighlighter>
+#include <QLexerHighlighter>
 
 // Qt
 #include <QComboBox>
@@ -65,6 +66,10 @@ void MainWindow::initData()
         {"Python", new QPythonCompleter(this)},
     };
 
+    // Highlighter, driven by language definition
+    auto lexerHighlighter = new QLexerHighlighter;
+    lexerHighlighter->load(":/definitions/lua.xml");
+
     m_highlighters = {
         {"None", nullptr},
         {"C++",  new QCXXHighlighter},
@@ -73,6 +78,7 @@ void MainWindow::initData()
         {"JSON", new QJSONHighlighter},
         {"LUA",  new QLuaHighlighter},
         {"Python",  new QPythonHighlighter},
+        {"LUA (definition)", lexerHighlighter},
     };
 
     m_styles = {
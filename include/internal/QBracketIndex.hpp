@@ -0,0 +1,162 @@
+#pragma once
+
+// Qt
+#include <QChar>
+#include <QVector>
+
+class QString;
+class QTextBlock;
+class QTextDocument;
+class QHighlightContext;
+class QHighlightBlockData;
+
+/**
+ * @brief Class, that describes brackets of single
+ * text block. Besides bracket positions it keeps
+ * depth summary for every bracket kind, so search
+ * for matching bracket skips blocks without reading
+ * their text. Summaries of blocks are combined by
+ * QBracketSummary, so blocks are skipped in groups.
+ */
+class QBracketIndex
+{
+public:
+
+    /**
+     * @brief Structure, that describes bracket
+     * in block.
+     */
+    struct Bracket
+    {
+        int position;
+        QChar character;
+    };
+
+    /**
+     * @brief Constructor. Creates empty index.
+     */
+    QBracketIndex();
+
+    /**
+     * @brief Constructor. Indexes all brackets
+     * of text.
+     * @param text Block text.
+     */
+    explicit QBracketIndex(const QString& text);
+
+    /**
+     * @brief Constructor. Indexes brackets of text,
+     * that are not formatted as strings or comments.
+     * @param text Block text.
+     * @param context Highlighting result for text.
+     */
+    QBracketIndex(const QString& text, const QHighlightContext& context);
+
+    /**
+     * @brief Constructor. Indexes brackets of text,
+     * that are not in string or comment tokens.
+     * @param text Block text.
+     * @param data Highlighter data with complete
+     * tokens for text.
+     */
+    QBracketIndex(const QString& text, const QHighlightBlockData& data);
+
+    /**
+     * @brief Static method for checking is character
+     * one of `()[]{}`.
+     */
+    static bool isBracket(QChar c);
+
+    /**
+     * @brief Static method for checking is character
+     * opening bracket.
+     */
+    static bool isOpening(QChar c);
+
+    /**
+     * @brief Static method for getting pair of bracket.
+     * @return Pair or null character if it's not
+     * a bracket.
+     */
+    static QChar counterpart(QChar c);
+
+    /**
+     * @brief Method for getting brackets in order
+     * of their positions.
+     */
+    const QVector<Bracket>& brackets() const;
+
+    /**
+     * @brief Method for getting difference between
+     * number of opening and closing brackets of
+     * bracket kind.
+     * @param bracket Any bracket of kind.
+     */
+    int delta(QChar bracket) const;
+
+    /**
+     * @brief Method for getting minimal depth of
+     * bracket kind, reached from block start. It's
+     * 0 or negative.
+     * @param bracket Any bracket of kind.
+     */
+    int minDepth(QChar bracket) const;
+
+    /**
+     * @brief Static method for getting bracket index
+     * of block. Index, maintained by highlighter, is
+     * used if it's actual. Otherwise brackets are
+     * indexed from block text.
+     * @param block Text block.
+     */
+    static QBracketIndex forBlock(const QTextBlock& block);
+
+    /**
+     * @brief Static method for finding matching bracket.
+     * @param document Text document.
+     * @param position Position of bracket.
+     * @return Position of matching bracket or -1 if
+     * there is no bracket at position or it's unmatched.
+     */
+    static int findMatchingBracket(QTextDocument* document, int position);
+
+    /**
+     * @brief Static method for finding nearest opening
+     * bracket before position, that is not closed
+     * before position.
+     * @param document Text document.
+     * @param position Position.
+     * @return Position of opening bracket or -1.
+     */
+    static int findEnclosingBracket(QTextDocument* document, int position);
+
+private:
+
+    static int kind(QChar c);
+
+    void append(int position, QChar c);
+
+    /**
+     * @brief Static method for searching bracket, that
+     * sets counter of bracket kind to zero.
+     * @param document Text document.
+     * @param block Block to start with.
+     * @param position Position in block. Brackets
+     * after (or before) it are checked.
+     * @param bracket Any bracket of kind.
+     * @param forward Search direction.
+     * @param counter Number of unmatched brackets.
+     * @return Position in document or -1.
+     */
+    static int search(QTextDocument* document,
+                      QTextBlock block,
+                      int position,
+                      QChar bracket,
+                      bool forward,
+                      int counter);
+
+    QVector<Bracket> m_brackets;
+
+    int m_depth[3];
+    int m_minDepth[3];
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+// Qt
+#include <QObject> // Required for inheritance
+#include <QChar>
+#include <QPair>
+#include <QTextBlock>
+#include <QVector>
+
+class QTextDocument;
+
+/**
+ * @brief Class, that describes bracket depths of whole
+ * document. Blocks are split into groups, that are kept
+ * in treap ordered by position. Every node summarizes
+ * block count and depths of its subtree, so group of
+ * block is found by block number and search for matching
+ * bracket skips groups in logarithmic time. Summary is
+ * created for document on first search. When blocks are
+ * added or removed, only groups of changed blocks are
+ * joined and summarized again on next search, groups
+ * after them are kept.
+ */
+class QBracketSummary : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Static method for getting summary of
+     * document. It's created, if it doesn't exist.
+     * @param document Text document.
+     */
+    static QBracketSummary* forDocument(QTextDocument* document);
+
+    /**
+     * @brief Static method for marking brackets of
+     * block as changed. It's called, when bracket
+     * index of block is changed without text change.
+     * @param block Text block.
+     */
+    static void invalidateBlock(const QTextBlock& block);
+
+    /**
+     * @brief Static method for marking brackets
+     * of all blocks as changed.
+     * @param document Text document.
+     */
+    static void invalidateDocument(const QTextDocument* document);
+
+    /**
+     * @brief Method for finding nearest block, at which
+     * counter of bracket kind may reach zero. Brackets in
+     * search direction are counted as opening.
+     * @param bracket Any bracket of kind.
+     * @param blockNumber Block to start after, it's
+     * not checked.
+     * @param forward Search direction.
+     * @param counter Number of unmatched brackets. It's
+     * updated with brackets of skipped blocks.
+     * @return Block number or -1.
+     */
+    int findBlock(QChar bracket, int blockNumber, bool forward, int& counter);
+
+private:
+
+    /**
+     * @brief Structure, that describes difference of
+     * depth and minimal depth of blocks.
+     */
+    struct Depth
+    {
+        int delta;
+        int minDepth;
+    };
+
+    /**
+     * @brief Structure, that describes group of blocks.
+     * It's node of treap, subtree summary is kept
+     * with summary of group itself.
+     */
+    struct Group
+    {
+        int left;
+        int right;
+        quint32 priority;
+
+        int blocks;
+        bool dirty;
+
+        // One depth for every bracket kind
+        Depth depths[3];
+
+        int totalBlocks;
+        bool hasDirty;
+        Depth totalDepths[3];
+    };
+
+    explicit QBracketSummary(QTextDocument* document);
+
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Method for marking group of block
+     * as changed. Blocks, that are reported before
+     * summary knows about added or removed blocks,
+     * are marked after it does.
+     */
+    void markBlock(const QTextBlock& block);
+
+    void markDirty(int blockNumber);
+
+    /**
+     * @brief Method for summarizing groups,
+     * that were changed.
+     */
+    void update();
+
+    /**
+     * @brief Method for creating groups
+     * of all blocks of document.
+     */
+    void rebuild();
+
+    /**
+     * @brief Method for replacing too large group
+     * with groups of regular size.
+     */
+    void replaceGroup(int group, int firstBlock);
+
+    /**
+     * @brief Method for creating treap of groups
+     * of consecutive blocks.
+     * @return Root group or -1.
+     */
+    int createGroups(int firstBlock, int blocks);
+
+    void summarizeGroup(int group, QTextBlock& block);
+
+    void collectDirty(int group, int firstBlock, QVector<QPair<int, int>>& groups) const;
+
+    void refresh(int group);
+
+    int allocate(int blocks);
+
+    void release(int group);
+
+    /**
+     * @brief Method for updating subtree
+     * summary of group from its children.
+     */
+    void pull(int group);
+
+    int merge(int first, int second);
+
+    /**
+     * @brief Method for splitting subtree by block.
+     * Groups, that start before block, are moved
+     * to first tree.
+     */
+    void split(int group, int blockNumber, int& first, int& second);
+
+    /**
+     * @brief Method for finding group of block.
+     * @param firstBlock First block of group.
+     * @return Group or -1.
+     */
+    int locate(int blockNumber, int& firstBlock) const;
+
+    int totalBlocks(int group) const;
+
+    Depth totalDepth(int group, int kind) const;
+
+    /**
+     * @brief Method for checking can counter reach
+     * zero in blocks of depth.
+     */
+    static bool isReached(const Depth& depth, bool forward, int counter);
+
+    static Depth combine(const Depth& first, const Depth& second);
+
+    /**
+     * @brief Method for descending treap to first
+     * group after or before boundary block, where
+     * counter may reach zero.
+     * @param offset Number of first block of subtree.
+     * @param firstBlock First block of found group.
+     * @return Group or -1.
+     */
+    int findGroup(int kind,
+                  int group,
+                  int offset,
+                  int boundary,
+                  bool forward,
+                  int& counter,
+                  int& firstBlock) const;
+
+    /**
+     * @brief Method for checking blocks of group
+     * one by one.
+     * @return Block number or -1.
+     */
+    int findInGroup(int kind,
+                    QTextBlock block,
+                    int lastBlock,
+                    bool forward,
+                    int& counter) const;
+
+    QTextDocument* m_document;
+
+    QVector<Group> m_groups;
+    QVector<int> m_freeGroups;
+    int m_root;
+    quint32 m_seed;
+
+    int m_blockCount;
+    bool m_valid;
+    QVector<QTextBlock> m_pendingBlocks;
+};
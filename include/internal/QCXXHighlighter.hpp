@@ -2,11 +2,6 @@
 
 // QCodeEditor
 #include <QStyleSyntaxHighlighter> // Required for inheritance
-#include <QHighlightRule>
-
-// Qt
-#include <QRegularExpression>
-#include <QVector>
 
 class QSyntaxStyle;
 
@@ -25,18 +20,7 @@ public:
      */
     explicit QCXXHighlighter(QTextDocument* document=nullptr);
 
-protected:
-    void highlightBlock(const QString& text) override;
-
 private:
 
-    QVector<QHighlightRule> m_highlightRules;
-
-    QRegularExpression m_includePattern;
-    QRegularExpression m_functionPattern;
-    QRegularExpression m_defTypePattern;
-
-    QRegularExpression m_commentStartPattern;
-    QRegularExpression m_commentEndPattern;
+    class Grammar;
 };
-
@@ -0,0 +1,93 @@
+#pragma once
+
+// Qt
+#include <QtGlobal>
+
+class QChar;
+class QString;
+class QRegularExpression;
+
+/**
+ * @brief Class, that describes set of characters. ASCII
+ * characters are stored exactly, all other characters
+ * share one flag. It's used to skip regular expressions,
+ * that can't match block: block text is scanned once and
+ * rule runs only if text contains one of characters, that
+ * rule's match may start with.
+ */
+class QCharacterSet
+{
+public:
+
+    /**
+     * @brief Constructor. Creates empty set.
+     */
+    QCharacterSet();
+
+    /**
+     * @brief Static method for creating set, that
+     * contains every character.
+     */
+    static QCharacterSet all();
+
+    /**
+     * @brief Static method for creating set of
+     * characters, that text contains.
+     * @param text Text.
+     */
+    static QCharacterSet fromText(const QString& text);
+
+    /**
+     * @brief Static method for getting characters, that
+     * any non empty match of regular expression may start
+     * with. If pattern uses syntax, that isn't analyzed,
+     * set of all characters is returned.
+     * @param expression Regular expression.
+     */
+    static QCharacterSet firstCharacters(const QRegularExpression& expression);
+
+    /**
+     * @brief Method for adding character.
+     */
+    void insert(QChar character);
+
+    /**
+     * @brief Method for adding range of
+     * characters, including both ends.
+     */
+    void insert(QChar first, QChar last);
+
+    /**
+     * @brief Method for adding characters
+     * of other set.
+     */
+    void unite(const QCharacterSet& other);
+
+    /**
+     * @brief Method for getting set of characters,
+     * that aren't in this set. Non ASCII characters
+     * are inverted as a whole.
+     */
+    QCharacterSet inverted() const;
+
+    /**
+     * @brief Method for checking is there common
+     * character in both sets.
+     */
+    bool intersects(const QCharacterSet& other) const;
+
+    /**
+     * @brief Method for checking if set contains character.
+     */
+    bool contains(QChar character) const;
+
+    /**
+     * @brief Method for checking is set empty.
+     */
+    bool isEmpty() const;
+
+private:
+
+    quint64 m_ascii[2];
+    bool m_other;
+};
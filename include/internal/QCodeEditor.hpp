@@ -1,5 +1,8 @@
 #pragma once
 
+// QCodeEditor
+#include <QFoldingTree>
+
 // Qt
 #include <QTextEdit> // Required for inheritance
 
@@ -7,7 +10,9 @@ class QCompleter;
 class QLineNumberArea;
 class QSyntaxStyle;
 class QStyleSyntaxHighlighter;
-class QFramedTextAttribute;
+class QOccurrenceOverlay;
+class QFileLoader;
+class QMinimap;
 
 /**
  * @brief Class, that describes code editor.
@@ -42,6 +47,8 @@ public:
 
     /**
      * @brief Method for setting syntax sty.e.
+     * Editor is updated, when style is loaded
+     * again.
      * @param style Pointer to syntax style.
      */
     void setSyntaxStyle(QSyntaxStyle* style);
@@ -94,6 +101,41 @@ public:
      */
     bool autoIndentation() const;
 
+    /**
+     * @brief Method for setting large file mode enabled.
+     * In this mode lines are not wrapped, so document
+     * layout is line oriented, and synchronous highlighter
+     * is switched to lazy highlighting of visible blocks.
+     * Highlighter applies formats only to visible blocks,
+     * so blocks, highlighted in idle time, are not laid
+     * out again.
+     */
+    void setLargeFileMode(bool enabled);
+
+    /**
+     * @brief Method for getting is large file mode enabled.
+     * Default: false
+     */
+    bool largeFileMode() const;
+
+    /**
+     * @brief Method for setting document size, above which
+     * large file mode is enabled automatically. Change, that
+     * exceeds threshold, switches highlighter to lazy mode
+     * before it processes inserted text. Lines are unwrapped
+     * after document finished notifying about change.
+     * @param characters Number of characters. 0 disables
+     * automatic switching.
+     */
+    void setLargeFileThreshold(int characters);
+
+    /**
+     * @brief Method for getting document size, above which
+     * large file mode is enabled automatically.
+     * Default: 4194304
+     */
+    int largeFileThreshold() const;
+
     /**
      * @brief Method for setting completer.
      * @param completer Pointer to completer object.
@@ -106,6 +148,153 @@ public:
      */
     QCompleter* completer() const;
 
+    /**
+     * @brief Method for moving cursor to bracket, that
+     * matches bracket near cursor. Brackets in strings
+     * and comments are skipped.
+     * @return Was matching bracket found.
+     */
+    bool jumpToMatchingBracket();
+
+    /**
+     * @brief Method for selecting text between nearest
+     * brackets, that enclose cursor or selection,
+     * including brackets. Repeated calls expand
+     * selection to outer scope.
+     * @return Was enclosing scope found.
+     */
+    bool selectEnclosingScope();
+
+    /**
+     * @brief Method for setting code folding enabled.
+     * Regions are found from brackets, multiline comments
+     * and strings, and optionally from indentation. Folded
+     * blocks are hidden and skipped by layout, line number
+     * area shows fold markers.
+     */
+    void setFoldingEnabled(bool enabled);
+
+    /**
+     * @brief Method for getting is code folding enabled.
+     * Default: true
+     */
+    bool foldingEnabled() const;
+
+    /**
+     * @brief Method for setting regions from indentation
+     * enabled. It's required for languages without
+     * brackets, like Python.
+     */
+    void setIndentationFolding(bool enabled);
+
+    /**
+     * @brief Method for getting are regions found
+     * from indentation.
+     * Default: false
+     */
+    bool indentationFolding() const;
+
+    /**
+     * @brief Method for folding or unfolding region,
+     * that starts at block.
+     * @param blockNumber Block number.
+     * @return Does region start at block.
+     */
+    bool toggleFold(int blockNumber);
+
+    /**
+     * @brief Method for checking is region, that
+     * starts at block, folded.
+     * @param blockNumber Block number.
+     */
+    bool isFolded(int blockNumber) const;
+
+    /**
+     * @brief Method for folding every region.
+     */
+    void foldAll();
+
+    /**
+     * @brief Method for unfolding every region.
+     */
+    void unfoldAll();
+
+    /**
+     * @brief Method for getting foldable regions.
+     */
+    const QFoldingTree& foldingTree() const;
+
+    /**
+     * @brief Method for setting minimap enabled. Minimap
+     * is shown at the right side of editor and shows
+     * whole document scaled down, colored with formats
+     * of highlighter. Click on it scrolls editor.
+     */
+    void setMinimapEnabled(bool enabled);
+
+    /**
+     * @brief Method for getting is minimap enabled.
+     * Default: false
+     */
+    bool minimapEnabled() const;
+
+    /**
+     * @brief Method for getting number of occurrences
+     * of selected word in document.
+     * @return Number of occurrences or -1 if they
+     * are still being counted.
+     */
+    int occurrenceCount() const;
+
+    /**
+     * @brief Method for opening file. File content replaces
+     * document text in chunks, while event loop keeps
+     * running. Editor is read only until loading is
+     * finished. Large file mode is enabled before loading,
+     * if file size is above large file threshold.
+     * Document is kept, if file can't be opened.
+     * Loading is cancelled, if document text is set
+     * or another file is opened.
+     * @param path Path to UTF-8 encoded file.
+     * @return Was file opened.
+     */
+    bool openFile(const QString& path);
+
+    /**
+     * @brief Method for cancelling file opening.
+     * Already loaded text stays in editor.
+     */
+    void cancelOpenFile();
+
+    /**
+     * @brief Method for checking is file being opened.
+     */
+    bool isOpeningFile() const;
+
+signals:
+
+    /**
+     * @brief Signal, that's emitted while file is
+     * being opened.
+     * @param bytesLoaded Number of loaded bytes.
+     * @param bytesTotal File size.
+     */
+    void openFileProgress(qint64 bytesLoaded, qint64 bytesTotal);
+
+    /**
+     * @brief Signal, that's emitted when file
+     * opening is stopped.
+     * @param completed Was whole file loaded.
+     */
+    void openFileFinished(bool completed);
+
+    /**
+     * @brief Signal, that's emitted when occurrences
+     * of selected word were counted.
+     * @param count Number of occurrences.
+     */
+    void occurrenceCountChanged(int count);
+
 public slots:
 
     /**
@@ -167,6 +356,14 @@ protected:
      */
     void resizeEvent(QResizeEvent* e) override;
 
+    /**
+     * @brief Method, that's called on viewport scrolling.
+     * This method is overloaded for scrolling line number
+     * area with the same offset, so only exposed part of
+     * it is repainted.
+     */
+    void scrollContentsBy(int dx, int dy) override;
+
     /**
      * @brief Method, that's called on any key press, posted
      * into code editor widget. This method is overloaded for:
@@ -187,12 +384,6 @@ protected:
 
 private:
 
-    /**
-     * @brief Method for initializing document
-     * layout handlers.
-     */
-    void initDocumentLayoutHandlers();
-
     /**
      * @brief Method for initializing default
      * monospace font.
@@ -206,16 +397,73 @@ private:
     void performConnections();
 
     /**
-     * @brief Method, that performs selection
-     * frame selection.
+     * @brief Method for switching highlighter to lazy
+     * mode and back with large file mode.
+     */
+    void updateLargeFileMode();
+
+    /**
+     * @brief Method for switching synchronous highlighter
+     * to lazy mode and formatting of visible blocks only,
+     * or switching it back.
+     */
+    void updateLargeFileHighlighting(bool lazy);
+
+    /**
+     * @brief Method for enabling large file mode, if
+     * document size is above threshold. It may be called
+     * from contents change of document, so only highlighter
+     * is switched immediately.
      */
-    void handleSelectionQuery(QTextCursor cursor);
+    void checkLargeFileThreshold();
+
+    /**
+     * @brief Method for enabling large file mode after
+     * returning to event loop.
+     */
+    void enableLargeFileMode();
 
     /**
      * @brief Method for updating geometry of line number area.
      */
     void updateLineGeometry();
 
+    /**
+     * @brief Method for marking changed blocks of
+     * folding tree and scheduling its update.
+     */
+    void invalidateFolding(int firstBlock, int lastBlock);
+
+    void scheduleFoldingUpdate();
+
+    /**
+     * @brief Method for scanning changed blocks
+     * for foldable regions.
+     */
+    void updateFolding();
+
+    /**
+     * @brief Method for hiding blocks, that are in
+     * folded regions, and showing all other blocks
+     * in range.
+     * @param first First block number.
+     * @param last Last block number.
+     */
+    void updateFoldedBlocks(int first, int last);
+
+    /**
+     * @brief Method for unfolding regions, that
+     * hide block with cursor.
+     */
+    void revealCursorBlock();
+
+    /**
+     * @brief Method for passing range of visible blocks
+     * to highlighter, that doesn't highlight whole
+     * document immediately.
+     */
+    void updateVisibleBlocks();
+
     /**
      * @brief Method, that performs completer processing.
      * Returns true if event has to be dropped.
@@ -251,6 +499,14 @@ private:
      */
     void highlightParenthesis(QList<QTextEdit::ExtraSelection>& extraSelection);
 
+    /**
+     * @brief Method for getting position of bracket,
+     * that's matched for current cursor: opening bracket
+     * after cursor or closing bracket before it.
+     * @return Position or -1.
+     */
+    int matchedBracketPosition();
+
     /**
      * @brief Method for getting number of indentation
      * spaces in current line. Tabs will be treated
@@ -260,14 +516,32 @@ private:
 
     QStyleSyntaxHighlighter* m_highlighter;
     QSyntaxStyle* m_syntaxStyle;
+    QMetaObject::Connection m_syntaxStyleConnection;
     QLineNumberArea* m_lineNumberArea;
     QCompleter* m_completer;
 
-    QFramedTextAttribute* m_framedAttribute;
+    QOccurrenceOverlay* m_occurrenceOverlay;
+    QFileLoader* m_fileLoader;
 
     bool m_autoIndentation;
     bool m_autoParentheses;
     bool m_replaceTab;
     QString m_tabReplace;
+
+    bool m_largeFileMode;
+    int m_largeFileThreshold;
+    LineWrapMode m_lineWrapMode;
+    bool m_highlighterSwitched;
+    bool m_largeFileModeScheduled;
+
+    bool m_undoRedoEnabled;
+    bool m_readOnly;
+
+    QFoldingTree m_foldingTree;
+    bool m_foldingEnabled;
+    bool m_foldingUpdateScheduled;
+
+    QMinimap* m_minimap;
+    bool m_minimapEnabled;
 };
 
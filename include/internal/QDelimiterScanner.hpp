@@ -0,0 +1,88 @@
+#pragma once
+
+// Qt
+#include <QChar>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes positions of delimiters
+ * of C family languages in block text: `/`, `*`, `"`,
+ * `'` and `#`. Text is scanned once with SSE2 or AVX2,
+ * if processor supports them, so comments, strings and
+ * preprocessor directives are searched only among these
+ * positions.
+ */
+class QDelimiterScanner
+{
+public:
+
+    /**
+     * @brief Constructor. Scans text.
+     * @param text Text. It has to live longer,
+     * than scanner.
+     */
+    explicit QDelimiterScanner(const QString& text);
+
+    // Disable copying
+    QDelimiterScanner(const QDelimiterScanner&) = delete;
+    QDelimiterScanner& operator=(const QDelimiterScanner&) = delete;
+
+    /**
+     * @brief Static method for checking if
+     * character is delimiter.
+     */
+    static bool isDelimiter(QChar character);
+
+    /**
+     * @brief Static method for finding positions
+     * of all delimiters.
+     * @param data Pointer to characters.
+     * @param length Number of characters.
+     * @param positions Vector, that positions
+     * are appended to in ascending order.
+     */
+    static void scan(const QChar* data, int length, QVector<int>& positions);
+
+    /**
+     * @brief Method for checking is there
+     * any delimiter in text.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Method for getting positions
+     * of all delimiters.
+     */
+    const QVector<int>& positions() const;
+
+    /**
+     * @brief Method for finding delimiter.
+     * @param delimiter Delimiter character.
+     * @param from Position to start search from.
+     * @return Position or -1 if it's not found.
+     */
+    int indexOf(QChar delimiter, int from=0) const;
+
+    /**
+     * @brief Method for finding two delimiters, that
+     * follow each other. For example comment start.
+     * @param first First delimiter character.
+     * @param second Second delimiter character.
+     * @param from Position to start search from.
+     * @return Position of first delimiter or -1 if
+     * it's not found.
+     */
+    int indexOf(QChar first, QChar second, int from=0) const;
+
+private:
+
+    /**
+     * @brief Method for getting index of first
+     * delimiter, that's not before position.
+     */
+    int lowerBound(int from) const;
+
+    const QString& m_text;
+    QVector<int> m_positions;
+};
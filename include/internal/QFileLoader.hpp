@@ -0,0 +1,135 @@
+#pragma once
+
+// Qt
+#include <QObject> // Required for inheritance
+#include <QFile>
+#include <QPointer>
+#include <QScopedPointer>
+#include <QString>
+#include <QTextDocument>
+
+class QTextDecoder;
+
+/**
+ * @brief Class, that describes loader, that appends
+ * file content to the end of text document in chunks.
+ * Chunks are read between event loop iterations, so
+ * user interface keeps running. File is memory mapped
+ * if it's possible.
+ */
+class QFileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent Pointer to parent QObject.
+     */
+    explicit QFileLoader(QObject* parent=nullptr);
+
+    /**
+     * @brief Destructor.
+     */
+    ~QFileLoader() override;
+
+    // Disable copying
+    QFileLoader(const QFileLoader&) = delete;
+    QFileLoader& operator=(const QFileLoader&) = delete;
+
+    /**
+     * @brief Method for opening file. Document isn't
+     * changed until loading is started, so it can be
+     * kept, if file can't be opened. Loading, that's
+     * already running, is cancelled.
+     * @param path Path to file.
+     * @return Was file opened.
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Method for getting size of opened file.
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Method for starting loading of opened
+     * file. File is decoded as UTF-8 and appended to
+     * document. Loading is cancelled, if document is
+     * changed by anything else than loader.
+     * @param document Pointer to text document.
+     */
+    void start(QTextDocument* document);
+
+    /**
+     * @brief Method for cancelling loading. Document
+     * keeps already loaded part of file.
+     */
+    void cancel();
+
+    /**
+     * @brief Method for checking is file being loaded.
+     */
+    bool isLoading() const;
+
+signals:
+
+    /**
+     * @brief Signal, that's emitted after every
+     * loaded chunk.
+     * @param bytesLoaded Number of loaded bytes.
+     * @param bytesTotal File size.
+     */
+    void progress(qint64 bytesLoaded, qint64 bytesTotal);
+
+    /**
+     * @brief Signal, that's emitted when loading
+     * is stopped.
+     * @param completed Was whole file loaded.
+     */
+    void finished(bool completed);
+
+private:
+
+    void scheduleChunks();
+
+    /**
+     * @brief Method for loading chunks until
+     * time slice is over.
+     */
+    void loadChunks();
+
+    /**
+     * @brief Method for reading and decoding
+     * next chunk of file.
+     */
+    QString readChunk(qint64 size);
+
+    /**
+     * @brief Method for inserting text at
+     * the end of document.
+     */
+    void append(const QString& text);
+
+    /**
+     * @brief Method for closing file.
+     */
+    void close();
+
+    void stop(bool completed);
+
+    QFile m_file;
+    uchar* m_map;
+    qint64 m_offset;
+    qint64 m_size;
+
+    QScopedPointer<QTextDecoder> m_decoder;
+    QString m_carriageReturn;
+
+    QPointer<QTextDocument> m_document;
+    QMetaObject::Connection m_documentConnection;
+    bool m_loading;
+    bool m_appending;
+    bool m_chunksScheduled;
+};
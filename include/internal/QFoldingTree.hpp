@@ -0,0 +1,344 @@
+#pragma once
+
+// Qt
+#include <QPair>
+#include <QVector>
+
+class QTextBlock;
+class QTextDocument;
+
+/**
+ * @brief Class, that describes foldable regions of document.
+ * Regions are found from `{}` and `[]` brackets, that are not
+ * in strings or comments, from blocks with non zero highlighter
+ * state (multiline comments and strings) and optionally from
+ * indentation. Regions are stored in interval tree, that's a
+ * treap ordered by first block. Added or removed blocks shift
+ * subtrees lazily, and every subtree knows block, at which its
+ * last region is closed, so regions, that are open at some
+ * block, are found in logarithmic time. They are the scanner
+ * state before block, so after edit only changed blocks are
+ * scanned, until scanner state converges with previous scan.
+ */
+class QFoldingTree
+{
+public:
+
+    /**
+     * @brief Enum, that describes source of region.
+     */
+    enum class Kind
+    {
+        Braces,
+        Brackets,
+        State,
+        Indentation
+    };
+
+    /**
+     * @brief Structure, that describes foldable region.
+     * First block stays visible, when region is folded.
+     */
+    struct Region
+    {
+        int start;
+        int end;
+        Kind kind;
+        bool folded;
+    };
+
+    /**
+     * @brief Constructor. Creates empty tree.
+     */
+    QFoldingTree();
+
+    /**
+     * @brief Method for enabling regions from indentation.
+     * Whole document is scanned again on next update.
+     * Default: false
+     * @param enabled Are indentation regions found.
+     */
+    void setIndentationBased(bool enabled);
+
+    /**
+     * @brief Method for checking are regions
+     * found from indentation.
+     */
+    bool isIndentationBased() const;
+
+    /**
+     * @brief Method for marking blocks as changed.
+     * Changes are accumulated until update.
+     * @param firstBlock First changed block.
+     * @param lastBlock Last changed block.
+     * @param blockCount Number of blocks in document
+     * after change.
+     */
+    void invalidate(int firstBlock, int lastBlock, int blockCount);
+
+    /**
+     * @brief Method for marking whole document as changed.
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Method for checking are there changes,
+     * that are not scanned yet.
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Method for scanning changed blocks.
+     * Folded regions, that still start at the same
+     * block, stay folded.
+     * @param document Text document.
+     * @return Range of blocks, whose visibility may
+     * be changed. Empty range if nothing was scanned.
+     */
+    QPair<int, int> update(QTextDocument* document);
+
+    /**
+     * @brief Method for finding longest region,
+     * that starts at block.
+     * @param blockNumber Block number.
+     * @return Region or region with negative start,
+     * if there is no region.
+     */
+    Region regionAt(int blockNumber) const;
+
+    /**
+     * @brief Method for folding or unfolding longest
+     * region, that starts at block.
+     * @param blockNumber Block number.
+     * @param folded Is region folded.
+     * @return Does region start at block.
+     */
+    bool setFolded(int blockNumber, bool folded);
+
+    /**
+     * @brief Method for folding or unfolding every region.
+     */
+    void setAllFolded(bool folded);
+
+    /**
+     * @brief Method for unfolding regions, that hide block.
+     * @param blockNumber Block number.
+     * @return Range of blocks, that were hidden by
+     * unfolded regions. Empty range if block wasn't
+     * hidden.
+     */
+    QPair<int, int> unfoldEnclosing(int blockNumber);
+
+    /**
+     * @brief Method for checking is there any
+     * folded region.
+     */
+    bool hasFoldedRegions() const;
+
+    /**
+     * @brief Method for finding nearest block at or
+     * before given one, that isn't hidden by folded
+     * regions.
+     * @param blockNumber Block number.
+     */
+    int visibleBlock(int blockNumber) const;
+
+    /**
+     * @brief Method for getting ranges of blocks, hidden
+     * by folded regions, that intersect given blocks.
+     * Ranges are sorted and don't overlap.
+     * @param firstBlock First block.
+     * @param lastBlock Last block.
+     */
+    QVector<QPair<int, int>> hiddenRanges(int firstBlock, int lastBlock) const;
+
+    /**
+     * @brief Method for removing all regions.
+     */
+    void clear();
+
+private:
+
+    /**
+     * @brief Structure, that describes region, found by
+     * scanner. Scanner also keeps entries, that can't be
+     * folded: unclosed brackets and indentation levels
+     * of single block. Entry is open at blocks after
+     * start till block, at which it's closed.
+     */
+    struct Entry
+    {
+        int start;
+        int end;
+        int closed;
+        int width;
+        Kind kind;
+        bool folded;
+    };
+
+    /**
+     * @brief Structure, that describes treap node. Values
+     * of node are actual, when shifts of all parents are
+     * applied. Shift of node isn't applied to children yet.
+     */
+    struct Node
+    {
+        Entry entry;
+        quint32 priority;
+        int left;
+        int right;
+        int shift;
+        int maxClosed;
+        int maxFoldedEnd;
+    };
+
+    /**
+     * @brief Structure, that describes open
+     * indentation level.
+     */
+    struct Indent
+    {
+        int width;
+        int block;
+    };
+
+    /**
+     * @brief Structure, that describes scanner
+     * state before some block.
+     */
+    struct State
+    {
+        QVector<int> braces;
+        QVector<int> brackets;
+        int stateStart;
+        QVector<Indent> indents;
+        int lastNonBlank;
+    };
+
+    /**
+     * @brief Structure, that describes how numbers of
+     * blocks of previous scan are changed by edits.
+     */
+    struct Mapping
+    {
+        static const int changedBlock = -2;
+
+        int firstChanged;
+        int lastChangedOld;
+        int delta;
+
+        /**
+         * @brief Method for getting new number of block.
+         * Negative numbers are kept.
+         * @return Block number or changedBlock if block
+         * was changed.
+         */
+        int operator()(int block) const;
+    };
+
+    /**
+     * @brief Method for scanning single block.
+     */
+    void scanBlock(State& state,
+                   const QTextBlock& block,
+                   int blockNumber,
+                   QVector<Entry>& entries) const;
+
+    /**
+     * @brief Method for closing entries, that
+     * are open at document end.
+     */
+    void finish(State& state,
+                int blockCount,
+                QVector<Entry>& entries) const;
+
+    /**
+     * @brief Method for getting scanner state before
+     * block from entries, that are open at block.
+     */
+    State stateAt(int blockNumber) const;
+
+    static void addEntry(QVector<Entry>& entries,
+                         int start,
+                         int end,
+                         int closed,
+                         int width,
+                         Kind kind);
+
+    static bool isFoldable(const Entry& entry);
+
+    static State emptyState();
+
+    static State mapState(const State& state, const Mapping& mapping);
+
+    static bool isEqual(const State& a, const State& b);
+
+    // Treap operations. Nodes are kept in one array
+    // and released nodes are reused.
+
+    int createNode(const Entry& entry);
+
+    void releaseNode(int node);
+
+    void insertEntry(const Entry& entry);
+
+    void applyShift(int node, int shift);
+
+    void push(int node);
+
+    void pull(int node);
+
+    void split(int node, int start, int& left, int& right);
+
+    int merge(int left, int right);
+
+    /**
+     * @brief Method for removing entries, that are open
+     * at block, from subtree.
+     * @return New root of subtree.
+     */
+    int extractOpen(int node, int blockNumber, QVector<Entry>& entries);
+
+    /**
+     * @brief Method for removing all entries of subtree.
+     */
+    void extractAll(int node, QVector<Entry>& entries);
+
+    void collectOpen(int node,
+                     int offset,
+                     int blockNumber,
+                     QVector<Entry>& entries) const;
+
+    void collectStarting(int node,
+                         int offset,
+                         int blockNumber,
+                         QVector<Entry>& entries) const;
+
+    void collectFolded(int node,
+                       int offset,
+                       int firstBlock,
+                       int lastBlock,
+                       QVector<Entry>& entries) const;
+
+    bool setFoldedAt(int node, const Region& region, bool folded);
+
+    void setFoldedAll(int node, bool folded);
+
+    void unfoldAt(int node, int blockNumber, QPair<int, int>& range);
+
+    bool m_indentationBased;
+
+    QVector<Node> m_nodes;
+    QVector<int> m_freeNodes;
+    int m_root;
+    quint32 m_seed;
+    int m_foldedCount;
+
+    // Number of blocks at last update
+    int m_blockCount;
+
+    bool m_dirty;
+    int m_dirtyFirst;
+    int m_dirtyLast;
+    int m_dirtyBlockCount;
+};
\ No newline at end of file
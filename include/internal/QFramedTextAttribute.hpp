@@ -3,6 +3,9 @@
 // Qt
 #include <QObject> // Required for inheritance
 #include <QTextObjectInterface> // Required for inheritance
+#include <QTextCursor>
+#include <QVector>
+#include <QSet>
 
 class QSyntaxStyle;
 
@@ -66,7 +69,8 @@ public:
 
     /**
      * @brief Method for clearing all frames
-     * with desired cursor.
+     * with desired cursor. Only positions, that
+     * were framed, are visited.
      */
     void clear(QTextCursor cursor);
 
@@ -83,6 +87,35 @@ public:
 
 private:
 
+    /**
+     * @brief Method for following changes of document,
+     * where text was framed. Frame characters, inserted
+     * by frame, undo or redo, are added to frames.
+     */
+    void trackDocument(QTextDocument* document);
+
+    /**
+     * @brief Method for adding frame characters from
+     * changed part of document to frames.
+     */
+    void addFrames(QTextDocument* document,
+                   int position,
+                   int charsRemoved,
+                   int charsAdded);
+
+    /**
+     * @brief Method for getting positions of framed
+     * characters in range of document.
+     * @param first First position.
+     * @param last Position after last one.
+     */
+    QSet<int> framedPositions(QTextDocument* document, int first, int last);
+
     QSyntaxStyle* m_style;
+
+    // Cursors, that select frame characters.
+    // Document keeps their positions up to date.
+    QVector<QTextCursor> m_frames;
+    QSet<QTextDocument*> m_trackedDocuments;
 };
 
@@ -0,0 +1,207 @@
+#pragma once
+
+// QCodeEditor
+#include <QBracketIndex>
+#include <QHighlightContext>
+#include <QTokenArena>
+
+// Qt
+#include <QTextBlockUserData> // Required for inheritance
+#include <QSharedPointer>
+
+class QTextBlock;
+
+/**
+ * @brief Class, that describes data, that
+ * QStyleSyntaxHighlighter stores in text blocks.
+ */
+class QHighlightBlockData : public QTextBlockUserData
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QHighlightBlockData();
+
+    /**
+     * @brief Destructor. Returns tokens to arena.
+     */
+    ~QHighlightBlockData() override;
+
+    // Disable copying
+    QHighlightBlockData(const QHighlightBlockData&) = delete;
+    QHighlightBlockData& operator=(const QHighlightBlockData&) = delete;
+
+    // Maximal number of tokens of single block. Block
+    // with more tokens keeps only first of them.
+    static const int maxTokens = 4096;
+
+    /**
+     * @brief Static method for getting highlighter
+     * data of text block.
+     * @param block Text block.
+     * @return Pointer to data or nullptr if block
+     * has no highlighter data.
+     */
+    static QHighlightBlockData* get(const QTextBlock& block);
+
+    /**
+     * @brief Enum, that describes highlighting
+     * status of block.
+     */
+    enum class Status
+    {
+        // Block is highlighted with actual state
+        // of previous block
+        Highlighted,
+
+        // Block is highlighted, but state of previous
+        // block may be outdated
+        Outdated,
+
+        // Block was not highlighted, it keeps
+        // formats from previous highlighting
+        Deferred
+    };
+
+    /**
+     * @brief Method for setting highlighting status.
+     * @param status Status.
+     */
+    void setStatus(Status status);
+
+    /**
+     * @brief Method for getting highlighting status.
+     * Default: Highlighted
+     */
+    Status status() const;
+
+    /**
+     * @brief Method for getting is block waiting
+     * to be highlighted in background.
+     */
+    bool isPending() const;
+
+    /**
+     * @brief Method for setting are formats, found by
+     * grammar, applied to block. Highlighter may skip
+     * them for blocks out of visible range.
+     * @param formatted Are formats applied.
+     */
+    void setFormatted(bool formatted);
+
+    /**
+     * @brief Method for getting are formats, found
+     * by grammar, applied to block.
+     * Default: true
+     */
+    bool isFormatted() const;
+
+    /**
+     * @brief Method for setting revision of highlighter,
+     * block was highlighted with. Highlighter increases
+     * revision, when whole document is highlighted again
+     * in lazy mode, instead of marking every block.
+     * @param revision Revision.
+     */
+    void setHighlightRevision(int revision);
+
+    /**
+     * @brief Method for getting revision of highlighter,
+     * block was highlighted with.
+     * Default: 0
+     */
+    int highlightRevision() const;
+
+    /**
+     * @brief Method for setting brackets of block,
+     * that are not part of strings or comments.
+     * @param index Bracket index.
+     */
+    void setBracketIndex(QBracketIndex index);
+
+    /**
+     * @brief Method for getting bracket index.
+     */
+    const QBracketIndex& bracketIndex() const;
+
+    /**
+     * @brief Method for checking was bracket index
+     * set by highlighter.
+     */
+    bool hasBracketIndex() const;
+
+    /**
+     * @brief Method for setting tokens from formats,
+     * found by grammar. Overlapping formats are resolved,
+     * formats, that were set later, win. Neighbour parts
+     * with the same format are joined. Tokens are applied
+     * again, when syntax style is changed, instead of
+     * running grammar.
+     * @param arena Arena of document tokens.
+     * @param ranges Formatted parts of block.
+     * @param length Block text length.
+     */
+    void setTokens(const QSharedPointer<QTokenArena>& arena,
+                   const QVector<QHighlightContext::Range>& ranges,
+                   int length);
+
+    /**
+     * @brief Method for checking were tokens
+     * set by highlighter.
+     */
+    bool hasTokens() const;
+
+    /**
+     * @brief Method for checking do tokens cover whole
+     * block. It's false if block has more than maxTokens
+     * formatted parts.
+     */
+    bool isTokensComplete() const;
+
+    /**
+     * @brief Method for getting number of tokens.
+     */
+    int tokenCount() const;
+
+    /**
+     * @brief Method for getting token. Tokens are
+     * ordered by position and don't overlap.
+     * @param index Token index.
+     */
+    const QTokenArena::Token& token(int index) const;
+
+    /**
+     * @brief Method for finding token, that
+     * contains position.
+     * @param position Position in block.
+     * @return Token index or -1.
+     */
+    int tokenAt(int position) const;
+
+    /**
+     * @brief Static method for getting format id of
+     * character of block, without reading block text.
+     * @param block Text block.
+     * @param position Position in block.
+     * @return Format id or -1 if character is not
+     * formatted or block has no tokens.
+     */
+    static int formatIdAt(const QTextBlock& block, int position);
+
+private:
+
+    Status m_status;
+    int m_highlightRevision;
+    bool m_formatted;
+
+    QBracketIndex m_bracketIndex;
+    bool m_hasBracketIndex;
+
+    QSharedPointer<QTokenArena> m_tokenArena;
+    QTokenArena::Token* m_tokens;
+    int m_tokenCount;
+    int m_tokenCapacity;
+    bool m_tokensComplete;
+};
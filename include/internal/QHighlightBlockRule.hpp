@@ -1,5 +1,8 @@
 #pragma once
 
+// QCodeEditor
+#include <QSyntaxStyle>
+
 // Qt
 #include <QRegularExpression>
 #include <QString>
@@ -9,16 +12,16 @@ struct QHighlightBlockRule
     QHighlightBlockRule() :
         startPattern(),
         endPattern(),
-        formatName()
+        formatId(-1)
     {}
 
     QHighlightBlockRule(QRegularExpression start, QRegularExpression end, QString format) :
         startPattern(std::move(start)),
         endPattern(std::move(end)),
-        formatName(std::move(format))
+        formatId(QSyntaxStyle::formatId(format))
     {}
 
     QRegularExpression startPattern;
     QRegularExpression endPattern;
-    QString formatName;
+    int formatId;
 };
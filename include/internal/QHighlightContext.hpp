@@ -0,0 +1,134 @@
+#pragma once
+
+// Qt
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+class QRegularExpression;
+
+/**
+ * @brief Class, that describes result of highlighting
+ * single text block. Grammars write formats and block
+ * state into it instead of the document, so it can be
+ * filled outside of GUI thread.
+ */
+class QHighlightContext
+{
+public:
+
+    /**
+     * @brief Structure, that describes formatted
+     * part of block.
+     */
+    struct Range
+    {
+        int start;
+        int length;
+        int formatId;
+    };
+
+    /**
+     * @brief Structure, that describes single run
+     * of rule, measured by instrumented context.
+     */
+    struct RuleRun
+    {
+        QString name;
+        qint64 nanoseconds;
+        int matches;
+    };
+
+    /**
+     * @brief Constructor.
+     * @param previousBlockState State of previous block.
+     */
+    explicit QHighlightContext(int previousBlockState=-1);
+
+    /**
+     * @brief Method for getting state of previous block.
+     * -1 if previous block has no state.
+     */
+    int previousBlockState() const;
+
+    /**
+     * @brief Method for getting state of current block.
+     * Default: -1
+     */
+    int currentBlockState() const;
+
+    /**
+     * @brief Method for setting state of current block.
+     * @param state State.
+     */
+    void setCurrentBlockState(int state);
+
+    /**
+     * @brief Method for setting format of block part.
+     * Formats, that were set later have higher priority.
+     * @param start Start position in block.
+     * @param count Number of characters.
+     * @param formatId Id of syntax style format.
+     */
+    void setFormat(int start, int count, int formatId);
+
+    /**
+     * @brief Method for getting all formats in order
+     * they were set.
+     */
+    const QVector<Range>& formats() const;
+
+    /**
+     * @brief Method for enabling measuring of rules.
+     * Default: false
+     * @param enabled Are rules measured.
+     */
+    void setInstrumented(bool enabled);
+
+    /**
+     * @brief Method for checking are rules measured.
+     */
+    bool isInstrumented() const;
+
+    /**
+     * @brief Method for starting measuring of rule.
+     * Does nothing if context is not instrumented, so
+     * grammars call it unconditionally.
+     * @param pattern Rule pattern, that names rule.
+     */
+    void beginRule(const QRegularExpression& pattern);
+
+    /**
+     * @brief Method for starting measuring of search
+     * of end pattern of multiline rule. It's named
+     * separately from rule start, that may have the
+     * same pattern.
+     * @param pattern End pattern.
+     */
+    void beginEndRule(const QRegularExpression& pattern);
+
+    /**
+     * @brief Method for finishing measuring of rule,
+     * started by beginRule.
+     * @param matches Number of rule matches.
+     */
+    void endRule(int matches);
+
+    /**
+     * @brief Method for getting measured rule runs
+     * in order they were finished.
+     */
+    const QVector<RuleRun>& ruleRuns() const;
+
+private:
+
+    int m_previousBlockState;
+    int m_currentBlockState;
+
+    QVector<Range> m_formats;
+
+    bool m_instrumented;
+    QString m_ruleName;
+    QElapsedTimer m_ruleTimer;
+    QVector<RuleRun> m_ruleRuns;
+};
@@ -1,5 +1,10 @@
 #pragma once
 
+// QCodeEditor
+#include <QSyntaxStyle>
+#include <QCharacterSet>
+#include <QHighlightContext>
+
 // Qt
 #include <QRegularExpression>
 #include <QString>
@@ -8,14 +13,48 @@ struct QHighlightRule
 {
     QHighlightRule() :
         pattern(),
-        formatName()
+        formatId(-1),
+        firstCharacters(QCharacterSet::all())
     {}
 
     QHighlightRule(QRegularExpression p, QString f) :
         pattern(std::move(p)),
-        formatName(std::move(f))
+        formatId(QSyntaxStyle::formatId(f)),
+        firstCharacters(QCharacterSet::firstCharacters(pattern))
     {}
 
+    /**
+     * @brief Method for formatting every match
+     * of rule in block text.
+     * @param text Block text.
+     * @param context Context, that receives formats.
+     */
+    void apply(const QString& text, QHighlightContext& context) const
+    {
+        context.beginRule(pattern);
+
+        int matches = 0;
+        auto matchIterator = pattern.globalMatch(text);
+
+        while (matchIterator.hasNext())
+        {
+            auto match = matchIterator.next();
+
+            context.setFormat(
+                match.capturedStart(),
+                match.capturedLength(),
+                formatId
+            );
+
+            ++matches;
+        }
+
+        context.endRule(matches);
+    }
+
     QRegularExpression pattern;
-    QString formatName;
+    int formatId;
+
+    // Rule is skipped, if block has none of these characters
+    QCharacterSet firstCharacters;
 };
\ No newline at end of file
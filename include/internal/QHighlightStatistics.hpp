@@ -0,0 +1,81 @@
+#pragma once
+
+// Qt
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+class QHighlightContext;
+
+/**
+ * @brief Structure, that describes measurements of
+ * highlighter: time of highlighting blocks, matches
+ * and time of every grammar rule, slowest blocks and
+ * number of blocks, that were highlighted again only
+ * because state of previous block was changed.
+ */
+struct QHighlightStatistics
+{
+    /**
+     * @brief Structure, that describes totals
+     * of single rule.
+     */
+    struct Rule
+    {
+        QString name;
+        qint64 calls;
+        qint64 matches;
+        qint64 nanoseconds;
+    };
+
+    /**
+     * @brief Structure, that describes single
+     * highlighted block.
+     */
+    struct Block
+    {
+        int blockNumber;
+        int length;
+        qint64 nanoseconds;
+    };
+
+    // Number of slowest blocks, that are kept
+    static const int slowestBlocksCount = 10;
+
+    /**
+     * @brief Constructor. Creates empty statistics.
+     */
+    QHighlightStatistics();
+
+    /**
+     * @brief Method for adding highlighted block.
+     * @param blockNumber Block number.
+     * @param length Block text length.
+     * @param nanoseconds Time of grammar run.
+     * @param context Instrumented context of block.
+     * @param cascade Was block highlighted because
+     * state of previous block was changed.
+     */
+    void addBlock(int blockNumber,
+                  int length,
+                  qint64 nanoseconds,
+                  const QHighlightContext& context,
+                  bool cascade);
+
+    /**
+     * @brief Method for converting statistics into
+     * JSON object. Rules are sorted by time.
+     */
+    QJsonObject toJson() const;
+
+    qint64 blocks;
+    qint64 nanoseconds;
+    qint64 cascades;
+
+    // Rules by name
+    QHash<QString, Rule> rules;
+
+    // Slowest blocks, slowest first
+    QVector<Block> slowestBlocks;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+// Qt
+#include <QCompleter> // Required for inheritance
+#include <QSet>
+#include <QStringList>
+
+class QIdentifierIndex;
+class QStringListModel;
+class QTextDocument;
+
+/**
+ * @brief Class, that describes completer with language
+ * keywords and identifiers of document. Identifiers are
+ * found by index in background and merged into sorted
+ * model row by row.
+ */
+class QIdentifierCompleter : public QCompleter
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent Pointer to parent QObject.
+     */
+    explicit QIdentifierCompleter(QObject* parent=nullptr);
+
+    // Disable copying
+    QIdentifierCompleter(const QIdentifierCompleter&) = delete;
+    QIdentifierCompleter& operator=(const QIdentifierCompleter&) = delete;
+
+    /**
+     * @brief Method for setting keywords, that are
+     * always completed.
+     * @param keywords Keywords.
+     */
+    void setKeywords(const QStringList& keywords);
+
+    /**
+     * @brief Method for setting document, which
+     * identifiers are completed. Code editor sets
+     * its document to completer.
+     * @param document Pointer to document or nullptr.
+     */
+    void setDocument(QTextDocument* document);
+
+    /**
+     * @brief Method for getting document, which
+     * identifiers are completed.
+     */
+    QTextDocument* document() const;
+
+private:
+
+    /**
+     * @brief Method for inserting new identifiers into
+     * model and removing disappeared ones. Keywords
+     * are never removed.
+     */
+    void mergeIdentifiers(const QStringList& added, const QStringList& removed);
+
+    /**
+     * @brief Method for getting position of first
+     * word, that isn't less than given one.
+     */
+    int lowerBound(const QString& word) const;
+
+    QStringListModel* m_model;
+    QIdentifierIndex* m_index;
+
+    QSet<QString> m_keywords;
+
+    // Sorted content of model
+    QStringList m_words;
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+// QCodeEditor
+#include <QIdentifierTrie>
+
+// Qt
+#include <QObject> // Required for inheritance
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+class QTextDocument;
+
+/**
+ * @brief Class, that describes index of identifiers
+ * of document. Changed blocks are sent to background
+ * thread, that splits them into identifiers and counts
+ * references to them. Only identifiers, that appeared
+ * in document or disappeared from it, are reported.
+ */
+class QIdentifierIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent Pointer to parent QObject.
+     */
+    explicit QIdentifierIndex(QObject* parent=nullptr);
+
+    /**
+     * @brief Destructor. Waits for background
+     * indexing to stop.
+     */
+    ~QIdentifierIndex() override;
+
+    // Disable copying
+    QIdentifierIndex(const QIdentifierIndex&) = delete;
+    QIdentifierIndex& operator=(const QIdentifierIndex&) = delete;
+
+    /**
+     * @brief Method for setting indexed document.
+     * Whole document is indexed again, changes of
+     * previous document are dropped. Text of blocks
+     * is copied in small chunks, when event loop
+     * is idle.
+     * @param document Pointer to document or nullptr.
+     */
+    void setDocument(QTextDocument* document);
+
+    /**
+     * @brief Method for getting indexed document.
+     */
+    QTextDocument* document() const;
+
+signals:
+
+    /**
+     * @brief Signal, that's emitted, when identifiers
+     * appeared in document or disappeared from it.
+     * @param added New identifiers.
+     * @param removed Identifiers without references.
+     */
+    void identifiersChanged(const QStringList& added, const QStringList& removed);
+
+private:
+
+    class Job;
+
+    /**
+     * @brief Structure, that describes replacement of
+     * blocks. Removed blocks are replaced with blocks,
+     * that have given text.
+     */
+    struct Update
+    {
+        int generation;
+        int first;
+        int removed;
+        QStringList texts;
+    };
+
+    /**
+     * @brief Method for sending blocks from first
+     * to last to background thread.
+     * @param removed Number of replaced blocks or
+     * -1 to replace all blocks.
+     */
+    void enqueue(int first, int last, int removed);
+
+    /**
+     * @brief Method for copying next chunk of blocks,
+     * that were not sent to background thread yet.
+     */
+    void scheduleSnapshot();
+
+    void processSnapshot();
+
+    /**
+     * @brief Method for applying update to trie. It's
+     * called from background thread only.
+     * @param changes Number of appeared identifiers
+     * minus number of disappeared ones.
+     */
+    void applyUpdate(const Update& update, QHash<QString, int>& changes);
+
+    /**
+     * @brief Method for sending changes to main thread.
+     * They are dropped, if document was changed.
+     */
+    void reportChanges(int generation, const QHash<QString, int>& changes);
+
+    QPointer<QTextDocument> m_document;
+    int m_blockCount;
+
+    // Blocks before this one were sent to background
+    // thread, others are copied by snapshot chunks
+    int m_indexedBlocks;
+    bool m_snapshotScheduled;
+
+    QThreadPool m_threadPool;
+    QAtomicInt m_generation;
+
+    // Queue of updates, shared with background thread
+    QMutex m_mutex;
+    QVector<Update> m_updates;
+    bool m_jobRunning;
+
+    // State of background thread
+    QIdentifierTrie m_trie;
+    QVector<QStringList> m_blockIdentifiers;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+// Qt
+#include <QChar>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes set of identifiers with
+ * reference counts. Identifiers are stored in a trie,
+ * so common prefixes are stored once. Nodes are kept
+ * in one array and removed nodes are reused. It's not
+ * thread safe.
+ */
+class QIdentifierTrie
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QIdentifierTrie();
+
+    /**
+     * @brief Method for adding reference to identifier.
+     * @param identifier Identifier.
+     * @return Is identifier new.
+     */
+    bool insert(const QString& identifier);
+
+    /**
+     * @brief Method for removing reference to identifier.
+     * Nodes without identifiers are released.
+     * @param identifier Identifier.
+     * @return Was last reference removed.
+     */
+    bool remove(const QString& identifier);
+
+    /**
+     * @brief Method for getting number of references
+     * to identifier.
+     * @param identifier Identifier.
+     */
+    int count(const QString& identifier) const;
+
+    /**
+     * @brief Method for getting number of
+     * different identifiers.
+     */
+    int size() const;
+
+    /**
+     * @brief Method for removing all identifiers.
+     */
+    void clear();
+
+private:
+
+    /**
+     * @brief Structure, that describes trie node.
+     * Children are sorted by character.
+     */
+    struct Node
+    {
+        QChar character;
+        int parent;
+        int count;
+        QVector<int> children;
+    };
+
+    /**
+     * @brief Method for getting position of first child,
+     * which character isn't less than given one.
+     */
+    int childPosition(const Node& node, QChar character) const;
+
+    /**
+     * @brief Method for getting node of identifier.
+     * @return Node index or -1.
+     */
+    int findNode(const QString& identifier) const;
+
+    int allocateNode(QChar character, int parent);
+
+    QVector<Node> m_nodes;
+    QVector<int> m_freeNodes;
+    int m_size;
+};
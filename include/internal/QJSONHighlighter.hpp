@@ -2,10 +2,6 @@
 
 // QCodeEditor
 #include <QStyleSyntaxHighlighter> // Required for inheritance
-#include <QHighlightRule>
-
-// Qt
-#include <QVector>
 
 /**
  * @brief Class, that describes JSON code
@@ -22,12 +18,8 @@ public:
      */
     explicit QJSONHighlighter(QTextDocument* document=nullptr);
 
-protected:
-
-    void highlightBlock(const QString& text) override;
-
 private:
-    QVector<QHighlightRule> m_highlightRules;
-    QRegularExpression m_keyRegex;
+
+    class Grammar;
 };
 
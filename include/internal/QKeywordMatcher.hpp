@@ -0,0 +1,122 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes keyword table. It
+ * splits text into identifiers in a single pass and
+ * looks every identifier up in a trie, so the cost
+ * of matching depends on text length only, not on
+ * the number of keywords.
+ */
+class QKeywordMatcher
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QKeywordMatcher();
+
+    /**
+     * @brief Static method for checking if name can be
+     * stored in keyword table. Only identifiers
+     * (`[A-Za-z0-9_]+`) are supported, everything else
+     * has to be matched with regular expression.
+     * @param name Keyword name.
+     * @return Is name an identifier.
+     */
+    static bool isIdentifier(const QString& name);
+
+    /**
+     * @brief Method for adding keyword into table. If keyword
+     * already exists, it's format id will be replaced.
+     * @param keyword Keyword. Must be identifier.
+     * @param formatId Syntax style format id for this keyword.
+     */
+    void insert(const QString& keyword, int formatId);
+
+    /**
+     * @brief Method for checking is there any keyword in table.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Method for getting format id of identifier.
+     * @param data Pointer to identifier characters.
+     * @param length Identifier length.
+     * @return Format id or -1 if it's not a keyword.
+     */
+    int find(const QChar* data, int length) const;
+
+    /**
+     * @brief Method for finding all keywords in text.
+     * Identifier boundaries are the same as `\b` in
+     * regular expressions.
+     * @param text Text.
+     * @param callback Functor, that will be called with
+     * keyword start, length and format id.
+     */
+    template<typename Callback>
+    void match(const QString& text, Callback callback) const
+    {
+        if (isEmpty())
+        {
+            return;
+        }
+
+        auto data = text.constData();
+        auto size = text.size();
+
+        int index = 0;
+        while (index < size)
+        {
+            if (!isWordCharacter(data[index]))
+            {
+                ++index;
+                continue;
+            }
+
+            auto start = index;
+            while (index < size && isWordCharacter(data[index]))
+            {
+                ++index;
+            }
+
+            auto format = find(data + start, index - start);
+
+            if (format >= 0)
+            {
+                callback(start, index - start, format);
+            }
+        }
+    }
+
+private:
+
+    static inline bool isWordCharacter(QChar c)
+    {
+        auto u = c.unicode();
+
+        return (u >= 'a' && u <= 'z') ||
+               (u >= 'A' && u <= 'Z') ||
+               (u >= '0' && u <= '9') ||
+               u == '_';
+    }
+
+    /**
+     * @brief Trie node. Children are stored as
+     * sorted singly linked list of siblings.
+     */
+    struct Node
+    {
+        ushort character;
+        int firstChild;
+        int nextSibling;
+        int format;
+    };
+
+    QVector<Node> m_nodes;
+};
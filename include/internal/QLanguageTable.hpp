@@ -0,0 +1,65 @@
+#pragma once
+
+// Qt
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Structure, that describes language file,
+ * compiled into library. Tables are generated from
+ * `resources/languages/*.xml` at build time by
+ * `cmake/GenerateLanguageTables.cmake`, so built-in
+ * highlighters and completers don't need to parse
+ * XML. QLanguage is still used for user languages.
+ */
+struct QLanguageTable
+{
+    /**
+     * @brief Structure, that describes
+     * language file section.
+     */
+    struct Section
+    {
+        const char* key;
+        const char* const* names;
+        int count;
+    };
+
+    /**
+     * @brief Static method for getting built-in
+     * language table.
+     * @param name Language file name without
+     * extension. For example `cpp`.
+     * @return Pointer to table or nullptr if there
+     * is no such language.
+     */
+    static const QLanguageTable* find(const QString& name);
+
+    /**
+     * @brief Method for getting available keys.
+     * Keys are sorted, like in QLanguage.
+     */
+    QStringList keys() const;
+
+    /**
+     * @brief Method for getting names from key.
+     * @param key Section key.
+     */
+    QStringList names(const QString& key) const;
+
+    /**
+     * @brief Method for getting names of all
+     * sections.
+     */
+    QStringList allNames() const;
+
+    const char* name;
+    const Section* sections;
+    int count;
+
+    /**
+     * @brief Generated tables of all built-in languages.
+     */
+    static const QLanguageTable builtin[];
+    static const int builtinCount;
+};
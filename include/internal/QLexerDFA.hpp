@@ -0,0 +1,129 @@
+#pragma once
+
+// QCodeEditor
+#include <QCharacterSet>
+
+// Qt
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Class, that describes deterministic automaton,
+ * compiled from set of rules. Every rule is a pattern
+ * in subset of regular expression syntax: literals,
+ * escapes (`\d`, `\w`, `\s`, `\D`, `\W`, `\S`, `\n`,
+ * `\t`, `\r` and escaped punctuation), `.`, classes,
+ * groups, alternation and quantifiers (`*`, `+`, `?`,
+ * `{n}`, `{n,}`, `{n,m}`). Assertions and references
+ * aren't supported, because they can't be expressed
+ * with automaton. Input is matched in linear time.
+ *
+ * All non ASCII characters are one input symbol, so
+ * classes can't distinguish them.
+ */
+class QLexerDFA
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    QLexerDFA();
+
+    /**
+     * @brief Method for adding rule. Rules have to be
+     * added before compilation.
+     * @param pattern Rule pattern.
+     * @return Rule id or -1, if pattern is invalid.
+     */
+    int addRule(const QString& pattern);
+
+    /**
+     * @brief Method for adding rule, that matches
+     * text literally.
+     * @param literal Text.
+     * @return Rule id or -1, if literal is empty.
+     */
+    int addLiteral(const QString& literal);
+
+    /**
+     * @brief Method for building automaton
+     * from added rules.
+     * @return Success. Compilation fails, if automaton
+     * is too large.
+     */
+    bool compile();
+
+    /**
+     * @brief Method for finding longest rule match at
+     * the start of text. If several rules match text of
+     * the same length, rule, that was added first, wins.
+     * @param data Pointer to characters.
+     * @param length Number of characters.
+     * @param rule Id of matched rule or -1.
+     * @return Length of match. 0 if there is no match.
+     */
+    int match(const QChar* data, int length, int& rule) const;
+
+    /**
+     * @brief Method for checking is automaton compiled.
+     */
+    bool isCompiled() const;
+
+private:
+
+    /**
+     * @brief Number of input symbols: ASCII
+     * characters and all other characters.
+     */
+    static const int symbolCount = 129;
+
+    /**
+     * @brief Maximal number of automaton states.
+     */
+    static const int maxStateCount = 4096;
+
+    /**
+     * @brief Structure, that describes state of
+     * nondeterministic automaton, that's built
+     * from rules before compilation.
+     */
+    struct NfaState
+    {
+        QCharacterSet characters;
+        int next;
+        QVector<int> epsilon;
+        int rule;
+    };
+
+    /**
+     * @brief Structure, that describes part of
+     * nondeterministic automaton.
+     */
+    struct Fragment
+    {
+        int start;
+        int end;
+    };
+
+    class Parser;
+
+    static int symbol(QChar character);
+
+    int addNfaState();
+
+    /**
+     * @brief Method for adding rule fragment
+     * to automaton start.
+     */
+    int addFragment(const Fragment& fragment);
+
+    QVector<int> closure(QVector<int> states) const;
+
+    QVector<NfaState> m_nfa;
+    int m_ruleCount;
+
+    QVector<int> m_transitions;
+    QVector<int> m_accept;
+    bool m_compiled;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+// QCodeEditor
+#include <QStyleSyntaxHighlighter> // Required for inheritance
+
+// Qt
+#include <QString>
+
+class QIODevice;
+
+/**
+ * @brief Class, that describes highlighter, that's
+ * driven by language definition. Definition is
+ * QLanguage file, extended with token rules and
+ * regions:
+ *
+ * @code{.xml}
+ * <root>
+ *     <section name="Keyword">
+ *         <name>if</name>
+ *     </section>
+ *     <identifier pattern="[A-Za-z_][A-Za-z0-9_]*"/>
+ *     <token format="Number" pattern="[0-9]+"/>
+ *     <region format="String" begin="&quot;" end="&quot;" escape="\"/>
+ *     <region format="Comment" begin="--[[" end="]]" multiline="true"/>
+ *     <region format="Comment" begin="--"/>
+ * </root>
+ * @endcode
+ *
+ * Section names, that are identifiers, are keywords.
+ * Other names and token patterns are compiled into
+ * QLexerDFA together with region starts, so block is
+ * highlighted in one pass with longest match. Region
+ * without end lasts till the end of line. Multiline
+ * region, that's open at the end of block, is kept in
+ * block state.
+ */
+class QLexerHighlighter : public QStyleSyntaxHighlighter
+{
+    Q_OBJECT
+public:
+
+    /**
+     * @brief Constructor.
+     * @param document Pointer to document.
+     */
+    explicit QLexerHighlighter(QTextDocument* document=nullptr);
+
+    /**
+     * @brief Method for loading language definition
+     * from file. Compiled definition is shared with
+     * other highlighters, that loaded the same file,
+     * until all of them are destroyed.
+     * @param fileName Path to file. Resource paths
+     * (for example `:/definitions/lua.xml`) are supported.
+     * @return Success.
+     */
+    bool load(const QString& fileName);
+
+    /**
+     * @brief Method for loading language definition
+     * from device. Definition isn't shared.
+     * @param device Pointer to device.
+     * @return Success.
+     */
+    bool load(QIODevice* device);
+
+    /**
+     * @brief Method for checking is language
+     * definition loaded.
+     */
+    bool isLoaded() const;
+
+private:
+
+    class Grammar;
+};
@@ -2,12 +2,17 @@
 
 // Qt
 #include <QWidget> // Required for inheritance
+#include <QStaticText>
+#include <QColor>
+#include <QFont>
 
 class QCodeEditor;
 class QSyntaxStyle;
 
 /**
  * @brief Class, that describes line number area widget.
+ * Besides line numbers it shows fold markers, clicking
+ * on marker folds or unfolds region.
  */
 class QLineNumberArea : public QWidget
 {
@@ -27,12 +32,15 @@ public:
 
     /**
      * @brief Overridden method for getting line number area
-     * size.
+     * size. Width is cached until number of digits in
+     * block count or editor font is changed.
      */
     QSize sizeHint() const override;
 
     /**
      * @brief Method for setting syntax style object.
+     * Colors of style are cached, so it has to be set
+     * again after style was changed.
      * @param style Pointer to syntax style.
      */
     void setSyntaxStyle(QSyntaxStyle* style);
@@ -46,11 +54,52 @@ public:
 protected:
     void paintEvent(QPaintEvent* event) override;
 
+    void mousePressEvent(QMouseEvent* event) override;
+
 private:
 
+    /**
+     * @brief Method for updating cached font metrics
+     * and digit glyphs, if editor font or number of
+     * digits was changed.
+     */
+    void updateMetrics() const;
+
+    /**
+     * @brief Method for drawing line number with
+     * pre-rendered digits, aligned to the right.
+     */
+    void drawNumber(QPainter& painter, int number, int right, int top) const;
+
+    /**
+     * @brief Method for drawing fold marker: triangle,
+     * that points right for folded region and down
+     * for unfolded one.
+     */
+    void drawFoldMarker(QPainter& painter, bool folded, int top) const;
+
+    /**
+     * @brief Method for getting width of fold marker
+     * column. It's 0 if folding is disabled.
+     */
+    int foldMarkerWidth() const;
+
     QSyntaxStyle* m_syntaxStyle;
 
     QCodeEditor* m_codeEditParent;
 
+    QColor m_backgroundColor;
+    QColor m_currentLineColor;
+    QColor m_otherLinesColor;
+
+    // Metrics cache, updated from const sizeHint
+    mutable QFont m_font;
+    mutable int m_digits;
+    mutable bool m_folding;
+    mutable int m_lineHeight;
+    mutable int m_width;
+    mutable int m_digitWidths[10];
+    mutable QStaticText m_digitTexts[10];
+
 };
 
@@ -1,13 +1,13 @@
 #pragma once
 
-// Qt
-#include <QCompleter> // Required for inheritance
+// QCodeEditor
+#include <QIdentifierCompleter> // Required for inheritance
 
 /**
  * @brief Class, that describes completer with
  * glsl specific types and functions.
  */
-class QLuaCompleter : public QCompleter
+class QLuaCompleter : public QIdentifierCompleter
 {
     Q_OBJECT
 
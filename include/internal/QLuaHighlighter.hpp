@@ -2,13 +2,6 @@
 
 // QCodeEditor
 #include <QStyleSyntaxHighlighter> // Required for inheritance
-#include <QHighlightRule>
-#include <QHighlightBlockRule>
-
-// Qt
-#include <QRegularExpression>
-#include <QVector>
-#include <QMap>
 
 class QSyntaxStyle;
 
@@ -27,14 +20,7 @@ public:
      */
     explicit QLuaHighlighter(QTextDocument* document=nullptr);
 
-protected:
-    void highlightBlock(const QString& text) override;
-
 private:
-    QVector<QHighlightRule> m_highlightRules;
-    QVector<QHighlightBlockRule> m_highlightBlockRules;
 
-    QRegularExpression m_requirePattern;
-    QRegularExpression m_functionPattern;
-    QRegularExpression m_defTypePattern;
+    class Grammar;
 };
@@ -0,0 +1,108 @@
+#pragma once
+
+// Qt
+#include <QWidget> // Required for inheritance
+#include <QCache>
+#include <QColor>
+#include <QImage>
+
+class QCodeEditor;
+class QSyntaxStyle;
+
+/**
+ * @brief Class, that describes minimap widget. It shows
+ * whole document scaled down: every character is a pixel,
+ * colored by formats, that highlighter has already set to
+ * block. Document is rendered in tiles of fixed number of
+ * blocks. Tiles are cached and only tiles with changed
+ * blocks are rendered again.
+ */
+class QMinimap : public QWidget
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param parent Pointer to parent code editor.
+     */
+    explicit QMinimap(QCodeEditor* parent=nullptr);
+
+    // Disable copying
+    QMinimap(const QMinimap&) = delete;
+    QMinimap& operator=(const QMinimap&) = delete;
+
+    /**
+     * @brief Overridden method for getting
+     * minimap size.
+     */
+    QSize sizeHint() const override;
+
+    /**
+     * @brief Method for setting syntax style object.
+     * Cached tiles are rendered again.
+     * @param style Pointer to syntax style.
+     */
+    void setSyntaxStyle(QSyntaxStyle* style);
+
+    /**
+     * @brief Method for getting syntax style.
+     * @return Pointer to syntax style.
+     */
+    QSyntaxStyle* syntaxStyle() const;
+
+    /**
+     * @brief Method for marking blocks as changed. If number
+     * of blocks was changed, every tile after first changed
+     * block is rendered again, because blocks are shifted.
+     * @param first First changed block.
+     * @param last Last changed block.
+     */
+    void invalidateBlocks(int first, int last);
+
+    /**
+     * @brief Method for dropping all cached tiles.
+     */
+    void invalidateAll();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+    void mousePressEvent(QMouseEvent* event) override;
+
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+
+    /**
+     * @brief Method for getting offset of minimap
+     * content. When document is higher than widget,
+     * content scrolls with editor.
+     */
+    int scrollOffset() const;
+
+    /**
+     * @brief Method for rendering blocks of tile.
+     * @param tile Tile index.
+     */
+    QImage renderTile(int tile) const;
+
+    /**
+     * @brief Method for scrolling editor, so block
+     * at minimap position is in the middle.
+     * @param y Position in widget.
+     */
+    void scrollTo(int y);
+
+    QSyntaxStyle* m_syntaxStyle;
+
+    QCodeEditor* m_codeEditParent;
+
+    QColor m_backgroundColor;
+    QColor m_textColor;
+    QColor m_viewportColor;
+
+    QCache<int, QImage> m_tiles;
+    int m_blockCount;
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+// Qt
+#include <QObject> // Required for inheritance
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QPointer>
+#include <QTextDocument>
+#include <QTimer>
+
+class QTextEdit;
+class QPainter;
+class QRect;
+class QSyntaxStyle;
+
+/**
+ * @brief Class, that describes layer with frames
+ * around occurrences of text. Frames are painted
+ * over editor viewport, so document is never
+ * changed. Occurrences in whole document are
+ * counted on background thread, that keeps copy
+ * of blocks. Only changed blocks are sent to it.
+ */
+class QOccurrenceOverlay : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * @brief Constructor.
+     * @param editor Pointer to text edit. It's
+     * also a parent of overlay.
+     */
+    explicit QOccurrenceOverlay(QTextEdit* editor);
+
+    /**
+     * @brief Destructor. Waits for background
+     * counting to stop.
+     */
+    ~QOccurrenceOverlay() override;
+
+    // Disable copying
+    QOccurrenceOverlay(const QOccurrenceOverlay&) = delete;
+    QOccurrenceOverlay& operator=(const QOccurrenceOverlay&) = delete;
+
+    /**
+     * @brief Method for setting text, which occurrences
+     * are framed. Search is case insensitive.
+     * @param text Text. Empty text removes frames.
+     */
+    void setText(const QString& text);
+
+    /**
+     * @brief Method for getting text, which
+     * occurrences are framed.
+     */
+    QString text() const;
+
+    /**
+     * @brief Method for getting number of occurrences
+     * in whole document. It's counted in background.
+     * @return Number of occurrences or -1 if it's
+     * not counted yet.
+     */
+    int totalCount() const;
+
+    /**
+     * @brief Method for setting syntax style
+     * for rendering.
+     */
+    void setSyntaxStyle(QSyntaxStyle* style);
+
+    /**
+     * @brief Method for painting frames. It's called
+     * from viewport paint event. Occurrences are
+     * searched only in blocks near painted area.
+     * @param painter Viewport painter.
+     * @param rect Painted area.
+     */
+    void paint(QPainter& painter, const QRect& rect);
+
+signals:
+
+    /**
+     * @brief Signal, that's emitted when counting
+     * of occurrences in whole document is finished.
+     * @param count Number of occurrences.
+     */
+    void totalCountChanged(int count);
+
+private:
+
+    class CountJob;
+
+    /**
+     * @brief Structure, that describes single
+     * occurrence.
+     */
+    struct Occurrence
+    {
+        int position;
+        int length;
+    };
+
+    /**
+     * @brief Structure, that describes replacement of
+     * blocks. Removed blocks are replaced with blocks,
+     * that have given text. Occurrences of text are
+     * counted.
+     */
+    struct Update
+    {
+        int generation;
+        int sequence;
+        int first;
+        int removed;
+        QStringList texts;
+        QString text;
+        int textRevision;
+    };
+
+    /**
+     * @brief Method for following document of editor.
+     * Editor may get new document by setDocument, that
+     * isn't virtual, so it's checked before document
+     * is used.
+     */
+    void trackDocument();
+
+    /**
+     * @brief Method for searching occurrences in
+     * blocks from first to last.
+     */
+    void searchOccurrences(int firstBlock, int lastBlock);
+
+    /**
+     * @brief Method for dropping found occurrences.
+     * Total count is unknown, until background
+     * thread counts it again.
+     */
+    void invalidate();
+
+    /**
+     * @brief Method for starting copy of document
+     * on background thread. It's started, when text
+     * is set for the first time.
+     */
+    void startCopy();
+
+    /**
+     * @brief Method for sending blocks from first
+     * to last to background thread.
+     * @param removed Number of replaced blocks or
+     * -1 to replace all blocks.
+     */
+    void enqueue(int first, int last, int removed);
+
+    /**
+     * @brief Method for copying next chunk of blocks,
+     * that were not sent to background thread yet.
+     */
+    void scheduleSnapshot();
+
+    void processSnapshot();
+
+    /**
+     * @brief Method for starting background job.
+     * It's delayed, so series of changes is
+     * counted once.
+     */
+    void startJob();
+
+    /**
+     * @brief Method for applying update to copy of
+     * document. Occurrences in replaced blocks are
+     * counted, if text wasn't changed. It's called
+     * from background thread only.
+     */
+    void applyUpdate(const Update& update);
+
+    /**
+     * @brief Method for counting occurrences in all
+     * copied blocks, after text was changed. It's
+     * called from background thread only.
+     * @return Is counting finished. It's stopped,
+     * when text or document is changed again.
+     */
+    bool countOccurrences(int generation, int textRevision);
+
+    void applyCount(int generation, int sequence, int count);
+
+    QTextEdit* m_editor;
+    QSyntaxStyle* m_style;
+
+    QPointer<QTextDocument> m_document;
+    QMetaObject::Connection m_documentConnection;
+
+    QString m_text;
+
+    QVector<Occurrence> m_occurrences;
+    int m_firstBlock;
+    int m_lastBlock;
+
+    int m_totalCount;
+    QThreadPool m_threadPool;
+    QAtomicInt m_countGeneration;
+    QAtomicInt m_textRevision;
+    QTimer m_jobTimer;
+
+    // Document is copied to background thread
+    // after text was set for the first time
+    bool m_copying;
+    int m_blockCount;
+
+    // Blocks before this one were sent to background
+    // thread, others are copied by snapshot chunks
+    int m_copiedBlocks;
+    bool m_snapshotScheduled;
+    int m_sequence;
+
+    // Queue of updates, shared with background thread
+    QMutex m_mutex;
+    QVector<Update> m_updates;
+    bool m_jobRunning;
+
+    // State of background thread
+    QVector<QString> m_blockTexts;
+    QVector<int> m_blockCounts;
+    QString m_countedText;
+    bool m_countsValid;
+    int m_count;
+};
@@ -2,12 +2,6 @@
 
 // QCodeEditor
 #include <QStyleSyntaxHighlighter> // Required for inheritance
-#include <QHighlightRule>
-#include <QHighlightBlockRule>
-
-// Qt
-#include <QRegularExpression>
-#include <QVector>
 
 class QSyntaxStyle;
 
@@ -26,16 +20,8 @@ public:
      */
     explicit QPythonHighlighter(QTextDocument* document=nullptr);
 
-protected:
-    void highlightBlock(const QString& text) override;
-
 private:
 
-    QVector<QHighlightRule> m_highlightRules;
-    QVector<QHighlightBlockRule> m_highlightBlockRules;
-
-    QRegularExpression m_includePattern;
-    QRegularExpression m_functionPattern;
-    QRegularExpression m_defTypePattern;
+    class Grammar;
 };
 
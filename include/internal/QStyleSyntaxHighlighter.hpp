@@ -1,9 +1,22 @@
 #pragma once
 
+// QCodeEditor
+#include <QHighlightContext>
+#include <QHighlightBlockData>
+#include <QHighlightStatistics>
+
 // Qt
 #include <QSyntaxHighlighter> // Required for inheritance
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QHash>
+#include <QPointer>
+#include <QTextDocument>
+#include <QElapsedTimer>
 
 class QSyntaxStyle;
+class QSyntaxGrammar;
 
 /**
  * @brief Class, that descrubes highlighter with
@@ -11,18 +24,65 @@ class QSyntaxStyle;
  */
 class QStyleSyntaxHighlighter : public QSyntaxHighlighter
 {
+    Q_OBJECT
+
 public:
 
+    /**
+     * @brief Enum, that describes when blocks
+     * are highlighted.
+     */
+    enum class HighlightMode
+    {
+        // Every block is highlighted immediately
+        Synchronous,
+
+        // Only visible blocks are highlighted immediately,
+        // other blocks are highlighted on background thread
+        Asynchronous,
+
+        // Only visible blocks are highlighted immediately,
+        // other blocks are highlighted on GUI thread in
+        // small time slices, when event loop is idle.
+        // Attaching, loading or highlighting document
+        // again doesn't go through every block.
+        Lazy
+    };
+
     /**
      * @brief Constructor.
      * @param document Pointer to text document.
      */
     explicit QStyleSyntaxHighlighter(QTextDocument* document=nullptr);
 
+    /**
+     * @brief Destructor. Waits for background
+     * highlighting to stop.
+     */
+    ~QStyleSyntaxHighlighter() override;
+
     // Disable copying
     QStyleSyntaxHighlighter(const QStyleSyntaxHighlighter&) = delete;
     QStyleSyntaxHighlighter& operator=(const QStyleSyntaxHighlighter&) = delete;
 
+    /**
+     * @brief Method for setting document. Highlighter
+     * data of blocks of previous document is removed,
+     * so its brackets and tokens are not used after
+     * highlighter is detached. It hides
+     * QSyntaxHighlighter::setDocument.
+     * @param document Pointer to text document.
+     */
+    void setDocument(QTextDocument* document);
+
+    /**
+     * @brief Method for highlighting whole document
+     * again. In lazy mode visible blocks are highlighted
+     * immediately and other blocks are only marked as
+     * pending. It hides QSyntaxHighlighter::rehighlight.
+     */
+    void rehighlight();
+
     /**
      * @brief Method for setting syntax style.
      * @param style Pointer to syntax style.
@@ -35,7 +95,356 @@ public:
      */
     QSyntaxStyle* syntaxStyle() const;
 
+    /**
+     * @brief Method for applying current syntax style to
+     * highlighted blocks. Blocks keep format ids, found by
+     * grammar, so only formats are replaced and grammar
+     * doesn't run again. Visible blocks are restyled
+     * immediately, other blocks are restyled in small
+     * time slices, when event loop is idle. Highlighters
+     * without grammar are highlighted again.
+     */
+    void restyle();
+
+    /**
+     * @brief Method for setting highlight mode. Asynchronous
+     * and lazy modes are only available for highlighters
+     * with grammar.
+     * @param mode Highlight mode.
+     */
+    void setHighlightMode(HighlightMode mode);
+
+    /**
+     * @brief Method for getting highlight mode.
+     * Default: Synchronous
+     */
+    HighlightMode highlightMode() const;
+
+    /**
+     * @brief Method for setting range of blocks, that are
+     * visible to user. These blocks and blocks near them
+     * are always highlighted immediately.
+     * @param first First visible block number.
+     * @param last Last visible block number.
+     */
+    void setVisibleBlocks(int first, int last);
+
+    /**
+     * @brief Method for enabling formatting of blocks out of
+     * visible range. When it's disabled, such blocks keep
+     * state, tokens and brackets, but formats are applied
+     * from tokens, when blocks become visible. So document
+     * layout isn't changed for every highlighted block.
+     * It's used only by highlighters with grammar in
+     * asynchronous and lazy modes.
+     * @param enabled Are blocks out of visible range formatted.
+     */
+    void setOffscreenFormattingEnabled(bool enabled);
+
+    /**
+     * @brief Method for checking are blocks out of
+     * visible range formatted.
+     * Default: true
+     */
+    bool isOffscreenFormattingEnabled() const;
+
+    /**
+     * @brief Method for getting grammar.
+     * @return Pointer to grammar. May be nullptr.
+     */
+    QSharedPointer<const QSyntaxGrammar> grammar() const;
+
+    /**
+     * @brief Method for getting number of bytes, that
+     * token arena of current document reserved from
+     * system.
+     */
+    qint64 tokenReservedBytes() const;
+
+    /**
+     * @brief Method for getting number of bytes of
+     * tokens, that blocks of current document use.
+     */
+    qint64 tokenUsedBytes() const;
+
+    /**
+     * @brief Method for enabling measuring of highlighting.
+     * Every highlighted block and every grammar rule run is
+     * timed. It's also enabled by setting environment variable
+     * QCODEEDITOR_HIGHLIGHT_STATISTICS to non zero value, then
+     * statistics are printed as JSON on destruction.
+     * @param enabled Is highlighting measured.
+     */
+    void setInstrumentationEnabled(bool enabled);
+
+    /**
+     * @brief Method for checking is highlighting measured.
+     * Default: false
+     */
+    bool isInstrumentationEnabled() const;
+
+    /**
+     * @brief Method for getting measurements, collected
+     * since instrumentation was enabled or reset.
+     */
+    QHighlightStatistics statistics() const;
+
+    /**
+     * @brief Method for clearing collected measurements.
+     */
+    void resetStatistics();
+
+signals:
+
+    /**
+     * @brief Signal, that's emitted, when grammar result
+     * was applied to block. Block state and brackets
+     * may be changed.
+     * @param blockNumber Block number.
+     */
+    void blockHighlighted(int blockNumber);
+
+    /**
+     * @brief Signal, that's emitted, when formats of
+     * blocks were replaced with formats of new style.
+     * @param first First restyled block.
+     * @param last Last restyled block.
+     */
+    void blocksRestyled(int first, int last);
+
+protected:
+
+    /**
+     * @brief Method for setting grammar, that's used
+     * for highlighting blocks. Derived classes, that
+     * don't set grammar have to override highlightBlock.
+     * @param grammar Pointer to grammar.
+     */
+    void setGrammar(QSharedPointer<const QSyntaxGrammar> grammar);
+
+    void highlightBlock(const QString& text) override;
+
 private:
+
+    class Job;
+
+    /**
+     * @brief Structure, that describes block
+     * highlighted on background thread.
+     */
+    struct BlockResult
+    {
+        int blockNumber;
+        QHighlightContext context;
+
+        // Measurements of instrumented job
+        qint64 nanoseconds;
+        bool cascade;
+    };
+
+    /**
+     * @brief Method for applying formats, state and
+     * bracket index from context to current block.
+     */
+    void applyContext(const QString& text, const QHighlightContext& context);
+
+    /**
+     * @brief Method for setting formats of current
+     * block from current syntax style.
+     */
+    void applyFormats(const QVector<QHighlightContext::Range>& ranges);
+
+    /**
+     * @brief Method for setting formats of current
+     * block from its tokens.
+     */
+    void applyTokens(const QHighlightBlockData& data);
+
+    /**
+     * @brief Method for adding current block, highlighted
+     * with instrumented context, to statistics.
+     */
+    void addStatistics(const QString& text,
+                       const QHighlightContext& context,
+                       qint64 nanoseconds,
+                       bool cascade);
+
+    /**
+     * @brief Method for keeping current block formats
+     * and state until block is highlighted on background.
+     */
+    void deferCurrentBlock();
+
+    /**
+     * @brief Method for removing highlighter data
+     * from blocks of current document.
+     */
+    void clearBlockData();
+
+    /**
+     * @brief Method for counting text changes of current
+     * document. Background results are discarded if
+     * document was changed since job started.
+     */
+    void trackDocument(QTextDocument* document);
+
+    /**
+     * @brief Method, that's called when tracked document
+     * is changed. In lazy mode changed blocks are marked
+     * as pending and only visible of them are highlighted.
+     */
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+
+    /**
+     * @brief Method for stopping QSyntaxHighlighter from
+     * highlighting changed blocks and whole document after
+     * it's attached. It's used in lazy mode.
+     */
+    void detachReformatting();
+
+    /**
+     * @brief Method for returning highlighting of changed
+     * blocks to QSyntaxHighlighter. Formats of blocks are
+     * cleared, so document has to be highlighted again.
+     */
+    void attachReformatting();
+
+    /**
+     * @brief Method for dropping highlighting of whole
+     * document, that QSyntaxHighlighter posts, when
+     * document is attached.
+     */
+    void dropDelayedRehighlight();
+
+    /**
+     * @brief Method for highlighting visible blocks and
+     * blocks near them, that are waiting for it.
+     */
+    void highlightVisibleBlocks();
+
+    bool isBlockVisible(int blockNumber) const;
+
+    /**
+     * @brief Method for checking are formats of current
+     * block applied, so they have to be replaced.
+     */
+    bool isCurrentBlockFormatted() const;
+
+    bool isPreviousBlockPending() const;
+
+    bool isBlockPending(const QTextBlock& block) const;
+
+    QHighlightBlockData* currentBlockData();
+
+    void setCurrentBlockStatus(QHighlightBlockData::Status status);
+
+    /**
+     * @brief Method for starting background job after
+     * returning to event loop.
+     */
+    void scheduleJob();
+
+    /**
+     * @brief Method for starting background job for
+     * pending blocks. Running job is cancelled.
+     */
+    void startJob();
+
+    void cancelJob();
+
+    /**
+     * @brief Method for processing next idle time
+     * slice in lazy mode.
+     */
+    void scheduleIdleSlice();
+
+    /**
+     * @brief Method for highlighting pending blocks
+     * in lazy mode until time slice is over.
+     */
+    void processIdleSlice();
+
+    /**
+     * @brief Method for extending range of blocks,
+     * that may be pending.
+     */
+    void addPendingBlocks(int firstBlock, int lastBlock);
+
+    /**
+     * @brief Method for applying stored format
+     * ranges of block with current syntax style.
+     */
+    void restyleBlock(const QTextBlock& block);
+
+    void scheduleRestyleSlice();
+
+    /**
+     * @brief Method for restyling blocks in document
+     * order until time slice is over.
+     */
+    void processRestyleSlice();
+
+    /**
+     * @brief Method, that's called on GUI thread with
+     * blocks highlighted by background job.
+     */
+    void applyResults(int generation,
+                      int revision,
+                      bool finished,
+                      const QVector<BlockResult>& results);
+
     QSyntaxStyle* m_syntaxStyle;
-};
+    QSharedPointer<const QSyntaxGrammar> m_grammar;
+
+    HighlightMode m_highlightMode;
+    int m_firstVisibleBlock;
+    int m_lastVisibleBlock;
+    bool m_offscreenFormatting;
+
+    QPointer<QTextDocument> m_trackedDocument;
+    QMetaObject::Connection m_documentConnection;
+    int m_revision;
+
+    // QSyntaxHighlighter doesn't highlight changed
+    // blocks itself in lazy mode
+    bool m_reformatDetached;
 
+    // Blocks with other revision are highlighted
+    // again in lazy mode
+    int m_highlightRevision;
+
+    // Tokens of blocks of tracked document
+    QSharedPointer<QTokenArena> m_tokenArena;
+
+    QThreadPool m_threadPool;
+    QAtomicInt m_jobGeneration;
+    bool m_jobScheduled;
+    bool m_jobRunning;
+    int m_jobFirstBlock;
+    int m_jobLastBlock;
+
+    QHash<int, BlockResult> m_results;
+    bool m_applyingResults;
+
+    bool m_idleSliceScheduled;
+    bool m_processingIdleSlice;
+    QElapsedTimer m_idleSliceTimer;
+    // Range of blocks, that may be pending, is
+    // empty if first is greater than last
+    int m_firstPendingBlock;
+    int m_lastPendingBlock;
+
+    // Block count before last contents change
+    int m_blockCount;
+
+    bool m_restyling;
+    bool m_restyleSliceScheduled;
+
+    // Next block to restyle, -1 if restyling is over
+    int m_restyleBlock;
+
+    bool m_instrumented;
+    QHighlightStatistics m_statistics;
+    int m_lastHighlightedBlock;
+    bool m_lastStateChanged;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+// Qt
+#include <QSharedPointer>
+
+// std
+#include <functional>
+
+class QString;
+class QHighlightContext;
+
+/**
+ * @brief Class, that describes language grammar,
+ * used by QStyleSyntaxHighlighter to highlight
+ * single block of text. Grammar must not change
+ * after construction, because it's shared with
+ * background highlighting thread.
+ */
+class QSyntaxGrammar
+{
+public:
+
+    /**
+     * @brief Type of function, that creates grammar.
+     * Function may return nullptr, if grammar can't
+     * be created.
+     */
+    using Factory = std::function<QSyntaxGrammar*()>;
+
+    virtual ~QSyntaxGrammar() = default;
+
+    /**
+     * @brief Static method for getting grammar, that's
+     * shared by whole process. Grammar is created with
+     * factory on first request and destroyed, when
+     * last reference to it is released. Method is
+     * thread safe.
+     * @param name Unique grammar name.
+     * @param factory Function, that creates grammar.
+     * @return Shared grammar or nullptr, if factory
+     * failed.
+     */
+    static QSharedPointer<const QSyntaxGrammar> shared(const QString& name, Factory factory);
+
+    /**
+     * @brief Method for highlighting single block of text.
+     * @param text Block text.
+     * @param context Context with state of previous block.
+     * Formats and state of current block are written into it.
+     */
+    virtual void highlightBlock(const QString& text, QHighlightContext& context) const = 0;
+};
@@ -5,6 +5,7 @@
 #include <QMap>
 #include <QString>
 #include <QTextCharFormat>
+#include <QVector>
 
 /**
  * @brief Class, that describes Qt style
@@ -24,7 +25,8 @@ public:
 
     /**
      * @brief Method for loading and parsing
-     * style.
+     * style. Style can be loaded again, while
+     * it's used, `changed` signal is emitted.
      * @param fl Style.
      * @return Success.
      */
@@ -50,12 +52,56 @@ public:
      */
     QTextCharFormat getFormat(QString name) const;
 
+    /**
+     * @brief Method for getting format by format id.
+     * It's an index in pre-resolved format table, so
+     * no string lookup or copying is performed.
+     * @param id Format id, returned by `formatId`.
+     * @return Text char format. Empty format if style
+     * has no such property.
+     */
+    const QTextCharFormat& getFormat(int id) const;
+
+    /**
+     * @brief Method for getting pre-resolved format
+     * table. It's indexed by format id and may be
+     * shorter than number of registered ids.
+     */
+    const QVector<QTextCharFormat>& formats() const;
+
+    /**
+     * @brief Static method for getting id of property
+     * name. Ids are shared by all styles and are
+     * registered on first request. It's thread safe.
+     * @param name Property name.
+     * @return Format id.
+     */
+    static int formatId(const QString& name);
+
+    /**
+     * @brief Static method for getting property name
+     * by format id.
+     * @param id Format id.
+     * @return Property name. Empty string if id
+     * is not registered.
+     */
+    static QString formatName(int id);
+
     /**
      * @brief Static method for getting default style.
      * @return Pointer to default style.
      */
     static QSyntaxStyle* defaultStyle();
 
+signals:
+
+    /**
+     * @brief Signal, that's emitted when style
+     * is loaded. Editors, that use style, update
+     * colors, cached from it.
+     */
+    void changed();
+
 private:
 
     QString m_name;
@@ -65,6 +111,8 @@ private:
         QTextCharFormat
     > m_data;
 
+    QVector<QTextCharFormat> m_formats;
+
     bool m_loaded;
 };
 
@@ -0,0 +1,125 @@
+#pragma once
+
+// Qt
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Class, that describes memory of tokens of all
+ * blocks of one document. Tokens are allocated from big
+ * chunks in power of two sized arrays, released arrays
+ * are reused by blocks of the same size class. So every
+ * token costs 8 bytes and block never reserves more than
+ * twice of tokens it has. It's not thread safe.
+ */
+class QTokenArena
+{
+public:
+
+    /**
+     * @brief Structure, that describes formatted part
+     * of block. Length and format id are packed into
+     * one 32 bit word.
+     */
+    struct Token
+    {
+        static const int lengthBits = 20;
+        static const int maxLength = (1 << lengthBits) - 1;
+        static const int maxFormatId = (1 << (32 - lengthBits)) - 1;
+
+        /**
+         * @brief Static method for creating token.
+         * @param start Position in block.
+         * @param length Length up to maxLength.
+         * @param formatId Format id up to maxFormatId.
+         */
+        static Token make(int start, int length, int formatId)
+        {
+            return {
+                static_cast<quint32>(start),
+                static_cast<quint32>(length) |
+                (static_cast<quint32>(formatId) << lengthBits)
+            };
+        }
+
+        int start() const
+        {
+            return static_cast<int>(offset);
+        }
+
+        int length() const
+        {
+            return static_cast<int>(lengthAndFormat & maxLength);
+        }
+
+        int end() const
+        {
+            return start() + length();
+        }
+
+        int formatId() const
+        {
+            return static_cast<int>(lengthAndFormat >> lengthBits);
+        }
+
+        quint32 offset;
+        quint32 lengthAndFormat;
+    };
+
+    /**
+     * @brief Constructor. Creates empty arena.
+     */
+    QTokenArena();
+
+    /**
+     * @brief Destructor. Releases all chunks.
+     */
+    ~QTokenArena();
+
+    // Disable copying
+    QTokenArena(const QTokenArena&) = delete;
+    QTokenArena& operator=(const QTokenArena&) = delete;
+
+    /**
+     * @brief Method for allocating array of tokens.
+     * @param count Number of tokens.
+     * @param capacity Number of tokens, that array
+     * really has. It's required for release.
+     * @return Pointer to array.
+     */
+    Token* allocate(int count, int& capacity);
+
+    /**
+     * @brief Method for releasing array of tokens.
+     * @param tokens Pointer to array.
+     * @param capacity Capacity, returned by allocate.
+     */
+    void release(Token* tokens, int capacity);
+
+    /**
+     * @brief Method for getting number of bytes,
+     * reserved from system.
+     */
+    qint64 reservedBytes() const;
+
+    /**
+     * @brief Method for getting number of bytes
+     * of arrays, that are given to blocks.
+     */
+    qint64 usedBytes() const;
+
+private:
+
+    static const int chunkTokens = 16384;
+    static const int minCapacity = 4;
+    static const int sizeClassCount = 13;
+
+    QVector<Token*> m_chunks;
+    int m_chunkFree;
+
+    // Released arrays by size class
+    QVector<Token*> m_freeLists[sizeClassCount];
+
+    qint64 m_reservedBytes;
+    qint64 m_usedBytes;
+};
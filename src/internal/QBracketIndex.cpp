@@ -0,0 +1,288 @@
+// QCodeEditor
+#include <QBracketIndex>
+#include <QBracketSummary>
+#include <QHighlightBlockData>
+#include <QHighlightContext>
+#include <QSyntaxStyle>
+
+// Qt
+#include <QString>
+#include <QTextBlock>
+#include <QTextDocument>
+
+QBracketIndex::QBracketIndex() :
+    m_brackets(),
+    m_depth(),
+    m_minDepth()
+{
+
+}
+
+QBracketIndex::QBracketIndex(const QString& text) :
+    QBracketIndex()
+{
+    for (int i = 0; i < text.size(); ++i)
+    {
+        if (isBracket(text[i]))
+        {
+            append(i, text[i]);
+        }
+    }
+}
+
+QBracketIndex::QBracketIndex(const QString& text, const QHighlightContext& context) :
+    QBracketIndex()
+{
+    static const int stringFormat = QSyntaxStyle::formatId("String");
+    static const int commentFormat = QSyntaxStyle::formatId("Comment");
+
+    auto hasBrackets = false;
+    for (auto&& c : text)
+    {
+        if (isBracket(c))
+        {
+            hasBrackets = true;
+            break;
+        }
+    }
+
+    if (!hasBrackets)
+    {
+        return;
+    }
+
+    // Resolving final format of every character,
+    // later formats have higher priority
+    QVector<int> formats(text.size(), -1);
+    for (auto&& range : context.formats())
+    {
+        auto end = qMin(range.start + range.length, text.size());
+
+        for (auto i = qMax(0, range.start); i < end; ++i)
+        {
+            formats[i] = range.formatId;
+        }
+    }
+
+    for (int i = 0; i < text.size(); ++i)
+    {
+        if (isBracket(text[i]) &&
+            formats[i] != stringFormat &&
+            formats[i] != commentFormat)
+        {
+            append(i, text[i]);
+        }
+    }
+}
+
+QBracketIndex::QBracketIndex(const QString& text, const QHighlightBlockData& data) :
+    QBracketIndex()
+{
+    static const int stringFormat = QSyntaxStyle::formatId("String");
+    static const int commentFormat = QSyntaxStyle::formatId("Comment");
+
+    // Tokens already keep final format of every
+    // formatted part, so it's not resolved again
+    for (int i = 0; i < text.size(); ++i)
+    {
+        if (!isBracket(text[i]))
+        {
+            continue;
+        }
+
+        auto token = data.tokenAt(i);
+        auto formatId = token < 0 ? -1 : data.token(token).formatId();
+
+        if (formatId != stringFormat &&
+            formatId != commentFormat)
+        {
+            append(i, text[i]);
+        }
+    }
+}
+
+bool QBracketIndex::isBracket(QChar c)
+{
+    return kind(c) >= 0;
+}
+
+bool QBracketIndex::isOpening(QChar c)
+{
+    return c == '(' || c == '[' || c == '{';
+}
+
+QChar QBracketIndex::counterpart(QChar c)
+{
+    switch (c.unicode())
+    {
+    case '(': return ')';
+    case ')': return '(';
+    case '[': return ']';
+    case ']': return '[';
+    case '{': return '}';
+    case '}': return '{';
+    default:  return QChar();
+    }
+}
+
+const QVector<QBracketIndex::Bracket>& QBracketIndex::brackets() const
+{
+    return m_brackets;
+}
+
+int QBracketIndex::delta(QChar bracket) const
+{
+    auto k = kind(bracket);
+
+    return k < 0 ? 0 : m_depth[k];
+}
+
+int QBracketIndex::minDepth(QChar bracket) const
+{
+    auto k = kind(bracket);
+
+    return k < 0 ? 0 : m_minDepth[k];
+}
+
+QBracketIndex QBracketIndex::forBlock(const QTextBlock& block)
+{
+    auto data = QHighlightBlockData::get(block);
+
+    // Deferred block keeps index of previous text
+    if (data != nullptr &&
+        data->hasBracketIndex() &&
+        data->status() != QHighlightBlockData::Status::Deferred)
+    {
+        return data->bracketIndex();
+    }
+
+    return QBracketIndex(block.text());
+}
+
+int QBracketIndex::findMatchingBracket(QTextDocument* document, int position)
+{
+    auto block = document->findBlock(position);
+
+    if (!block.isValid())
+    {
+        return -1;
+    }
+
+    auto positionInBlock = position - block.position();
+    auto index = forBlock(block);
+
+    for (auto&& bracket : index.brackets())
+    {
+        if (bracket.position == positionInBlock)
+        {
+            return search(
+                document,
+                block,
+                positionInBlock,
+                bracket.character,
+                isOpening(bracket.character),
+                1
+            );
+        }
+    }
+
+    return -1;
+}
+
+int QBracketIndex::findEnclosingBracket(QTextDocument* document, int position)
+{
+    auto block = document->findBlock(position);
+
+    if (!block.isValid())
+    {
+        return -1;
+    }
+
+    // Nearest unmatched opening bracket of any kind
+    auto result = -1;
+    for (auto&& bracket : {QChar('('), QChar('['), QChar('{')})
+    {
+        result = qMax(
+            result,
+            search(document, block, position - block.position(), bracket, false, 1)
+        );
+    }
+
+    return result;
+}
+
+int QBracketIndex::kind(QChar c)
+{
+    switch (c.unicode())
+    {
+    case '(': case ')': return 0;
+    case '[': case ']': return 1;
+    case '{': case '}': return 2;
+    default:            return -1;
+    }
+}
+
+void QBracketIndex::append(int position, QChar c)
+{
+    auto k = kind(c);
+
+    m_depth[k] += isOpening(c) ? 1 : -1;
+    m_minDepth[k] = qMin(m_minDepth[k], m_depth[k]);
+
+    m_brackets.append({position, c});
+}
+
+int QBracketIndex::search(QTextDocument* document,
+                          QTextBlock block,
+                          int position,
+                          QChar bracket,
+                          bool forward,
+                          int counter)
+{
+    auto k = kind(bracket);
+    auto index = forBlock(block);
+
+    while (true)
+    {
+        auto& brackets = index.brackets();
+
+        // Searching inside of block
+        for (int i = 0; i < brackets.size(); ++i)
+        {
+            auto& current = brackets[forward ? i : brackets.size() - 1 - i];
+
+            if (kind(current.character) != k ||
+                (forward && current.position <= position) ||
+                (!forward && current.position >= position))
+            {
+                continue;
+            }
+
+            // Counting brackets in search direction as opening
+            counter += isOpening(current.character) == forward ? 1 : -1;
+
+            if (counter == 0)
+            {
+                return block.position() + current.position;
+            }
+        }
+
+        // Skipping blocks, that can't close all brackets
+        auto blockNumber = QBracketSummary::forDocument(document)->findBlock(
+            bracket,
+            block.blockNumber(),
+            forward,
+            counter
+        );
+
+        if (blockNumber < 0)
+        {
+            return -1;
+        }
+
+        block = document->findBlockByNumber(blockNumber);
+        index = forBlock(block);
+
+        position = forward ? -1 : block.length();
+    }
+}
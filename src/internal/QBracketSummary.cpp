@@ -0,0 +1,717 @@
+// QCodeEditor
+#include <QBracketSummary>
+#include <QBracketIndex>
+
+// Qt
+#include <QTextBlock>
+#include <QTextDocument>
+
+// Number of blocks, that are summarized in one group.
+// Changed groups up to twice as large are kept.
+static const int groupBlocks = 32;
+
+// Opening brackets in order of kinds.
+static const char openingBrackets[] = {'(', '[', '{'};
+static const int kindCount = 3;
+
+static int kindOf(QChar bracket)
+{
+    auto opening = QBracketIndex::isOpening(bracket) ?
+        bracket :
+        QBracketIndex::counterpart(bracket);
+
+    for (int k = 0; k < kindCount; ++k)
+    {
+        if (opening == openingBrackets[k])
+        {
+            return k;
+        }
+    }
+
+    return -1;
+}
+
+QBracketSummary* QBracketSummary::forDocument(QTextDocument* document)
+{
+    if (document == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto summary = document->findChild<QBracketSummary*>(QString(), Qt::FindDirectChildrenOnly);
+
+    if (summary == nullptr)
+    {
+        summary = new QBracketSummary(document);
+    }
+
+    return summary;
+}
+
+void QBracketSummary::invalidateBlock(const QTextBlock& block)
+{
+    auto document = block.document();
+
+    if (document == nullptr)
+    {
+        return;
+    }
+
+    auto summary = document->findChild<QBracketSummary*>(QString(), Qt::FindDirectChildrenOnly);
+
+    if (summary != nullptr)
+    {
+        summary->markBlock(block);
+    }
+}
+
+void QBracketSummary::invalidateDocument(const QTextDocument* document)
+{
+    if (document == nullptr)
+    {
+        return;
+    }
+
+    auto summary = document->findChild<QBracketSummary*>(QString(), Qt::FindDirectChildrenOnly);
+
+    if (summary != nullptr)
+    {
+        summary->m_valid = false;
+    }
+}
+
+QBracketSummary::QBracketSummary(QTextDocument* document) :
+    QObject(document),
+    m_document(document),
+    m_groups(),
+    m_freeGroups(),
+    m_root(-1),
+    m_seed(2463534242u),
+    m_blockCount(document->blockCount()),
+    m_valid(false),
+    m_pendingBlocks()
+{
+    connect(
+        m_document,
+        &QTextDocument::contentsChange,
+        this,
+        &QBracketSummary::onContentsChange
+    );
+}
+
+int QBracketSummary::findBlock(QChar bracket, int blockNumber, bool forward, int& counter)
+{
+    auto kind = kindOf(bracket);
+
+    if (kind < 0)
+    {
+        return -1;
+    }
+
+    update();
+
+    auto groupStart = 0;
+    auto group = locate(blockNumber, groupStart);
+
+    if (group < 0)
+    {
+        return -1;
+    }
+
+    auto groupEnd = groupStart + m_groups[group].blocks;
+
+    // Rest of group of first block
+    auto lastBlock = forward ? groupEnd - 1 : groupStart;
+
+    if (blockNumber != lastBlock)
+    {
+        auto block = m_document->findBlockByNumber(blockNumber);
+
+        auto found = findInGroup(
+            kind,
+            forward ? block.next() : block.previous(),
+            lastBlock,
+            forward,
+            counter
+        );
+
+        if (found >= 0)
+        {
+            return found;
+        }
+    }
+
+    auto firstBlock = 0;
+
+    group = findGroup(
+        kind,
+        m_root,
+        0,
+        forward ? groupEnd : groupStart,
+        forward,
+        counter,
+        firstBlock
+    );
+
+    if (group < 0)
+    {
+        return -1;
+    }
+
+    lastBlock = firstBlock + m_groups[group].blocks - 1;
+
+    if (!forward)
+    {
+        qSwap(firstBlock, lastBlock);
+    }
+
+    return findInGroup(
+        kind,
+        m_document->findBlockByNumber(firstBlock),
+        lastBlock,
+        forward,
+        counter
+    );
+}
+
+void QBracketSummary::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+
+    auto blockCount = m_document->blockCount();
+    auto addedBlocks = blockCount - m_blockCount;
+
+    m_blockCount = blockCount;
+
+    if (!m_valid)
+    {
+        m_pendingBlocks.clear();
+        return;
+    }
+
+    auto first = qMax(0, m_document->findBlock(position).blockNumber());
+    auto last = qMax(first, m_document->findBlock(position + charsAdded).blockNumber());
+
+    // Last changed block before change
+    auto lastRemoved = qBound(first, last - addedBlocks, blockCount - addedBlocks - 1);
+
+    auto firstGroupStart = 0;
+    locate(first, firstGroupStart);
+
+    // Groups of changed blocks are joined into one,
+    // groups after them keep their summaries
+    int before, changed, after;
+    split(m_root, lastRemoved + 1, changed, after);
+    split(changed, firstGroupStart, before, changed);
+
+    auto blocks = totalBlocks(changed) + addedBlocks;
+    release(changed);
+
+    // Change doesn't match summary,
+    // it's created again on next search
+    if (blocks <= 0)
+    {
+        m_valid = false;
+        return;
+    }
+
+    auto group = allocate(blocks);
+    m_groups[group].dirty = true;
+    pull(group);
+
+    m_root = merge(merge(before, group), after);
+
+    for (auto& block : m_pendingBlocks)
+    {
+        if (block.isValid())
+        {
+            markDirty(block.blockNumber());
+        }
+    }
+
+    m_pendingBlocks.clear();
+}
+
+void QBracketSummary::markBlock(const QTextBlock& block)
+{
+    if (!m_valid)
+    {
+        return;
+    }
+
+    // Highlighter may handle change of document
+    // before summary, then block numbers are shifted
+    if (m_document->blockCount() != m_blockCount)
+    {
+        m_pendingBlocks.append(block);
+        return;
+    }
+
+    markDirty(block.blockNumber());
+}
+
+void QBracketSummary::markDirty(int blockNumber)
+{
+    if (blockNumber < 0 || blockNumber >= m_blockCount)
+    {
+        return;
+    }
+
+    auto group = m_root;
+
+    while (group >= 0)
+    {
+        auto& node = m_groups[group];
+        auto leftBlocks = totalBlocks(node.left);
+
+        node.hasDirty = true;
+
+        if (blockNumber < leftBlocks)
+        {
+            group = node.left;
+        }
+        else if (blockNumber < leftBlocks + node.blocks)
+        {
+            node.dirty = true;
+            return;
+        }
+        else
+        {
+            blockNumber -= leftBlocks + node.blocks;
+            group = node.right;
+        }
+    }
+}
+
+void QBracketSummary::update()
+{
+    if (!m_valid)
+    {
+        rebuild();
+        return;
+    }
+
+    if (m_root < 0 || !m_groups[m_root].hasDirty)
+    {
+        return;
+    }
+
+    QVector<QPair<int, int>> groups;
+    collectDirty(m_root, 0, groups);
+
+    for (auto& pair : groups)
+    {
+        auto group = pair.first;
+
+        if (m_groups[group].blocks > 2 * groupBlocks)
+        {
+            replaceGroup(group, pair.second);
+            continue;
+        }
+
+        auto block = m_document->findBlockByNumber(pair.second);
+
+        summarizeGroup(group, block);
+        m_groups[group].dirty = false;
+    }
+
+    refresh(m_root);
+}
+
+void QBracketSummary::rebuild()
+{
+    m_groups.clear();
+    m_freeGroups.clear();
+    m_pendingBlocks.clear();
+
+    m_blockCount = m_document->blockCount();
+    m_root = createGroups(0, m_blockCount);
+    m_valid = true;
+}
+
+void QBracketSummary::replaceGroup(int group, int firstBlock)
+{
+    auto blocks = m_groups[group].blocks;
+
+    int before, middle, after;
+    split(m_root, firstBlock, before, middle);
+
+    // Group is first one of middle tree
+    split(middle, 1, middle, after);
+
+    release(middle);
+
+    m_root = merge(
+        merge(before, createGroups(firstBlock, blocks)),
+        after
+    );
+}
+
+int QBracketSummary::createGroups(int firstBlock, int blocks)
+{
+    auto root = -1;
+    auto block = m_document->findBlockByNumber(firstBlock);
+
+    while (blocks > 0)
+    {
+        auto group = allocate(qMin(blocks, groupBlocks));
+
+        summarizeGroup(group, block);
+        pull(group);
+
+        root = merge(root, group);
+        blocks -= m_groups[group].blocks;
+    }
+
+    return root;
+}
+
+void QBracketSummary::summarizeGroup(int group, QTextBlock& block)
+{
+    Depth depths[kindCount] = {};
+
+    for (int i = 0; i < m_groups[group].blocks && block.isValid(); ++i, block = block.next())
+    {
+        auto index = QBracketIndex::forBlock(block);
+
+        for (int k = 0; k < kindCount; ++k)
+        {
+            depths[k] = combine(
+                depths[k],
+                {index.delta(openingBrackets[k]), index.minDepth(openingBrackets[k])}
+            );
+        }
+    }
+
+    for (int k = 0; k < kindCount; ++k)
+    {
+        m_groups[group].depths[k] = depths[k];
+    }
+}
+
+void QBracketSummary::collectDirty(int group,
+                                   int firstBlock,
+                                   QVector<QPair<int, int>>& groups) const
+{
+    if (group < 0 || !m_groups[group].hasDirty)
+    {
+        return;
+    }
+
+    auto& node = m_groups[group];
+    auto groupStart = firstBlock + totalBlocks(node.left);
+
+    collectDirty(node.left, firstBlock, groups);
+
+    if (node.dirty)
+    {
+        groups.append({group, groupStart});
+    }
+
+    collectDirty(node.right, groupStart + node.blocks, groups);
+}
+
+void QBracketSummary::refresh(int group)
+{
+    if (group < 0 || !m_groups[group].hasDirty)
+    {
+        return;
+    }
+
+    refresh(m_groups[group].left);
+    refresh(m_groups[group].right);
+    pull(group);
+}
+
+int QBracketSummary::allocate(int blocks)
+{
+    // Xorshift, priorities only have to be random
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Group group = {};
+    group.left = -1;
+    group.right = -1;
+    group.priority = m_seed;
+    group.blocks = blocks;
+
+    if (!m_freeGroups.isEmpty())
+    {
+        auto index = m_freeGroups.takeLast();
+        m_groups[index] = group;
+        return index;
+    }
+
+    m_groups.append(group);
+
+    return m_groups.size() - 1;
+}
+
+void QBracketSummary::release(int group)
+{
+    if (group < 0)
+    {
+        return;
+    }
+
+    release(m_groups[group].left);
+    release(m_groups[group].right);
+
+    m_freeGroups.append(group);
+}
+
+void QBracketSummary::pull(int group)
+{
+    auto& node = m_groups[group];
+
+    node.totalBlocks = totalBlocks(node.left) + node.blocks + totalBlocks(node.right);
+    node.hasDirty = node.dirty ||
+        (node.left >= 0 && m_groups[node.left].hasDirty) ||
+        (node.right >= 0 && m_groups[node.right].hasDirty);
+
+    for (int k = 0; k < kindCount; ++k)
+    {
+        node.totalDepths[k] = combine(
+            combine(totalDepth(node.left, k), node.depths[k]),
+            totalDepth(node.right, k)
+        );
+    }
+}
+
+int QBracketSummary::merge(int first, int second)
+{
+    if (first < 0)
+    {
+        return second;
+    }
+
+    if (second < 0)
+    {
+        return first;
+    }
+
+    if (m_groups[first].priority > m_groups[second].priority)
+    {
+        auto right = merge(m_groups[first].right, second);
+        m_groups[first].right = right;
+        pull(first);
+
+        return first;
+    }
+
+    auto left = merge(first, m_groups[second].left);
+    m_groups[second].left = left;
+    pull(second);
+
+    return second;
+}
+
+void QBracketSummary::split(int group, int blockNumber, int& first, int& second)
+{
+    if (group < 0)
+    {
+        first = -1;
+        second = -1;
+        return;
+    }
+
+    auto& node = m_groups[group];
+    auto leftBlocks = totalBlocks(node.left);
+
+    if (leftBlocks < blockNumber)
+    {
+        int left, right;
+        split(node.right, blockNumber - leftBlocks - node.blocks, left, right);
+
+        node.right = left;
+        first = group;
+        second = right;
+    }
+    else
+    {
+        int left, right;
+        split(node.left, blockNumber, left, right);
+
+        node.left = right;
+        first = left;
+        second = group;
+    }
+
+    pull(group);
+}
+
+int QBracketSummary::locate(int blockNumber, int& firstBlock) const
+{
+    auto group = m_root;
+    firstBlock = 0;
+
+    while (group >= 0)
+    {
+        auto& node = m_groups[group];
+        auto leftBlocks = totalBlocks(node.left);
+
+        if (blockNumber < leftBlocks)
+        {
+            group = node.left;
+        }
+        else if (blockNumber < leftBlocks + node.blocks)
+        {
+            firstBlock += leftBlocks;
+            return group;
+        }
+        else
+        {
+            blockNumber -= leftBlocks + node.blocks;
+            firstBlock += leftBlocks + node.blocks;
+            group = node.right;
+        }
+    }
+
+    return -1;
+}
+
+int QBracketSummary::totalBlocks(int group) const
+{
+    return group < 0 ? 0 : m_groups[group].totalBlocks;
+}
+
+QBracketSummary::Depth QBracketSummary::totalDepth(int group, int kind) const
+{
+    return group < 0 ? Depth{0, 0} : m_groups[group].totalDepths[kind];
+}
+
+bool QBracketSummary::isReached(const Depth& depth, bool forward, int counter)
+{
+    // Brackets in search direction are counted as
+    // opening, so backward search reaches zero at
+    // lowest depth, counted from end of blocks
+    return forward ?
+        counter + depth.minDepth <= 0 :
+        depth.delta - depth.minDepth >= counter;
+}
+
+QBracketSummary::Depth QBracketSummary::combine(const Depth& first, const Depth& second)
+{
+    return {
+        first.delta + second.delta,
+        qMin(first.minDepth, first.delta + second.minDepth)
+    };
+}
+
+int QBracketSummary::findGroup(int kind,
+                               int group,
+                               int offset,
+                               int boundary,
+                               bool forward,
+                               int& counter,
+                               int& firstBlock) const
+{
+    if (group < 0)
+    {
+        return -1;
+    }
+
+    auto& node = m_groups[group];
+    auto end = offset + node.totalBlocks;
+
+    // Groups after boundary are searched forward,
+    // groups before it are searched backward
+    if (forward ? end <= boundary : offset >= boundary)
+    {
+        return -1;
+    }
+
+    auto& depth = node.totalDepths[kind];
+
+    // Whole subtree is skipped, if counter
+    // can't reach zero in it
+    if ((forward ? offset >= boundary : end <= boundary) &&
+        !isReached(depth, forward, counter))
+    {
+        counter += forward ? depth.delta : -depth.delta;
+        return -1;
+    }
+
+    auto groupStart = offset + totalBlocks(node.left);
+    auto groupEnd = groupStart + node.blocks;
+
+    auto first = forward ? node.left : node.right;
+    auto second = forward ? node.right : node.left;
+
+    auto found = findGroup(
+        kind,
+        first,
+        forward ? offset : groupEnd,
+        boundary,
+        forward,
+        counter,
+        firstBlock
+    );
+
+    if (found >= 0)
+    {
+        return found;
+    }
+
+    if (forward ? groupStart >= boundary : groupEnd <= boundary)
+    {
+        auto& own = node.depths[kind];
+
+        if (isReached(own, forward, counter))
+        {
+            firstBlock = groupStart;
+            return group;
+        }
+
+        counter += forward ? own.delta : -own.delta;
+    }
+
+    return findGroup(
+        kind,
+        second,
+        forward ? groupEnd : offset,
+        boundary,
+        forward,
+        counter,
+        firstBlock
+    );
+}
+
+int QBracketSummary::findInGroup(int kind,
+                                 QTextBlock block,
+                                 int lastBlock,
+                                 bool forward,
+                                 int& counter) const
+{
+    if (!block.isValid())
+    {
+        return -1;
+    }
+
+    auto bracket = QChar(openingBrackets[kind]);
+    auto number = block.blockNumber();
+
+    while (block.isValid())
+    {
+        auto index = QBracketIndex::forBlock(block);
+        Depth depth = {index.delta(bracket), index.minDepth(bracket)};
+
+        if (isReached(depth, forward, counter))
+        {
+            return number;
+        }
+
+        counter += forward ? depth.delta : -depth.delta;
+
+        if (number == lastBlock)
+        {
+            break;
+        }
+
+        block = forward ? block.next() : block.previous();
+        number += forward ? 1 : -1;
+    }
+
+    return -1;
+}
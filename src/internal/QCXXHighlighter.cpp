@@ -1,42 +1,86 @@
 // QCodeEditor
 #include <QCXXHighlighter>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
 #include <QSyntaxStyle>
-#include <QLanguage>
+#include <QHighlightRule>
+#include <QCharacterSet>
+#include <QDelimiterScanner>
+#include <QKeywordMatcher>
+#include <QLanguageTable>
 
 // Qt
-#include <QFile>
+#include <QRegularExpression>
+#include <QVector>
 
+/**
+ * @brief Class, that describes C++ grammar.
+ */
+class QCXXHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    QKeywordMatcher m_keywordMatcher;
+    QVector<QHighlightRule> m_highlightRules;
+
+    QRegularExpression m_includePattern;
+    QRegularExpression m_functionPattern;
+    QRegularExpression m_defTypePattern;
+
+    int m_preprocessorFormat;
+    int m_stringFormat;
+    int m_typeFormat;
+    int m_functionFormat;
+    int m_commentFormat;
+};
 
 QCXXHighlighter::QCXXHighlighter(QTextDocument* document) :
-    QStyleSyntaxHighlighter(document),
+    QStyleSyntaxHighlighter(document)
+{
+    setGrammar(QSyntaxGrammar::shared(
+        "CXX",
+        []() -> QSyntaxGrammar* { return new Grammar(); }
+    ));
+}
+
+QCXXHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_keywordMatcher(),
     m_highlightRules     (),
     m_includePattern     (QRegularExpression(R"(#include\s+([<"][a-zA-Z0-9*._]+[">]))")),
     m_functionPattern    (QRegularExpression(R"(\b([A-Za-z0-9_]+(?:\s+|::))*([A-Za-z0-9_]+)(?=\())")),
     m_defTypePattern     (QRegularExpression(R"(\b([A-Za-z0-9_]+)\s+[A-Za-z]{1}[A-Za-z0-9_]+\s*[;=])")),
-    m_commentStartPattern(QRegularExpression(R"(/\*)")),
-    m_commentEndPattern  (QRegularExpression(R"(\*/)"))
+    m_preprocessorFormat(QSyntaxStyle::formatId("Preprocessor")),
+    m_stringFormat(QSyntaxStyle::formatId("String")),
+    m_typeFormat(QSyntaxStyle::formatId("Type")),
+    m_functionFormat(QSyntaxStyle::formatId("Function")),
+    m_commentFormat(QSyntaxStyle::formatId("Comment"))
 {
-    Q_INIT_RESOURCE(qcodeeditor_resources);
-    QFile fl(":/languages/cpp.xml");
-
-    if (!fl.open(QIODevice::ReadOnly))
-    {
-        return;
-    }
+    auto language = QLanguageTable::find("cpp");
 
-    QLanguage language(&fl);
-
-    if (!language.isLoaded())
+    if (language == nullptr)
     {
         return;
     }
 
-    auto keys = language.keys();
+    auto keys = language->keys();
     for (auto&& key : keys)
     {
-        auto names = language.names(key);
+        auto names = language->names(key);
         for (auto&& name : names)
         {
+            if (QKeywordMatcher::isIdentifier(name))
+            {
+                m_keywordMatcher.insert(name, QSyntaxStyle::formatId(key));
+                continue;
+            }
+
             m_highlightRules.append({
                 QRegularExpression(QString(R"(\b%1\b)").arg(name)),
                 key
@@ -49,29 +93,16 @@ QCXXHighlighter::QCXXHighlighter(QTextDocument* document) :
         QRegularExpression(R"(\b(0b|0x){0,1}[\d.']+\b)"),
         "Number"
     });
-
-    // Strings
-    m_highlightRules.append({
-        QRegularExpression(R"("[^\n"]*")"),
-        "String"
-    });
-
-    // Define
-    m_highlightRules.append({
-        QRegularExpression(R"(#[a-zA-Z_]+)"),
-        "Preprocessor"
-    });
-
-    // Single line
-    m_highlightRules.append({
-        QRegularExpression(R"(//[^\n]*)"),
-        "Comment"
-    });
 }
 
-void QCXXHighlighter::highlightBlock(const QString& text)
+void QCXXHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
 {
+    // Comments, strings and preprocessor are
+    // searched only among delimiters
+    QDelimiterScanner delimiters(text);
+
     // Checking for include
+    if (delimiters.indexOf('#') >= 0)
     {
         auto matchIterator = m_includePattern.globalMatch(text);
 
@@ -79,16 +110,16 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Preprocessor")
+                m_preprocessorFormat
             );
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("String")
+                m_stringFormat
             );
         }
     }
@@ -100,16 +131,16 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                m_typeFormat
             );
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                m_functionFormat
             );
         }
     }
@@ -120,60 +151,112 @@ void QCXXHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("Type")
+                m_typeFormat
             );
         }
     }
 
+    m_keywordMatcher.match(text, [&context](int start, int length, int formatId)
+    {
+        context.setFormat(start, length, formatId);
+    });
+
+    auto characters = QCharacterSet::fromText(text);
+
     for (auto& rule : m_highlightRules)
     {
-        auto matchIterator = rule.pattern.globalMatch(text);
+        if (!rule.firstCharacters.intersects(characters))
+        {
+            continue;
+        }
 
-        while (matchIterator.hasNext())
+        rule.apply(text, context);
+    }
+
+    // Strings
+    {
+        auto start = delimiters.indexOf('"');
+
+        while (start >= 0)
         {
-            auto match = matchIterator.next();
+            auto end = delimiters.indexOf('"', start + 1);
 
-            setFormat(
-                match.capturedStart(),
-                match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
-            );
+            if (end < 0)
+            {
+                break;
+            }
+
+            context.setFormat(start, end - start + 1, m_stringFormat);
+            start = delimiters.indexOf('"', end + 1);
+        }
+    }
+
+    // Define
+    {
+        auto start = delimiters.indexOf('#');
+
+        while (start >= 0)
+        {
+            auto end = start + 1;
+
+            while (end < text.size() &&
+                   (text[end] == '_' ||
+                    (text[end] >= 'a' && text[end] <= 'z') ||
+                    (text[end] >= 'A' && text[end] <= 'Z')))
+            {
+                ++end;
+            }
+
+            if (end > start + 1)
+            {
+                context.setFormat(start, end - start, m_preprocessorFormat);
+            }
+
+            start = delimiters.indexOf('#', end);
         }
     }
 
-    setCurrentBlockState(0);
+    // Single line
+    {
+        auto start = delimiters.indexOf('/', '/');
+
+        if (start >= 0)
+        {
+            context.setFormat(start, text.size() - start, m_commentFormat);
+        }
+    }
+
+    context.setCurrentBlockState(0);
 
     int startIndex = 0;
-    if (previousBlockState() != 1)
+    if (context.previousBlockState() != 1)
     {
-        startIndex = text.indexOf(m_commentStartPattern);
+        startIndex = delimiters.indexOf('/', '*');
     }
 
     while (startIndex >= 0)
     {
-        auto match = m_commentEndPattern.match(text, startIndex);
-
-        int endIndex = match.capturedStart();
+        int endIndex = delimiters.indexOf('*', '/', startIndex);
         int commentLength = 0;
 
         if (endIndex == -1)
         {
-            setCurrentBlockState(1);
+            context.setCurrentBlockState(1);
             commentLength = text.length() - startIndex;
         }
         else
         {
-            commentLength = endIndex - startIndex + match.capturedLength();
+            commentLength = endIndex - startIndex + 2;
         }
 
-        setFormat(
+        context.setFormat(
             startIndex,
             commentLength,
-            syntaxStyle()->getFormat("Comment")
+            m_commentFormat
         );
-        startIndex = text.indexOf(m_commentStartPattern, startIndex + commentLength);
+        startIndex = delimiters.indexOf('/', '*', startIndex + commentLength);
     }
 }
@@ -0,0 +1,615 @@
+// QCodeEditor
+#include <QCharacterSet>
+
+// Qt
+#include <QRegularExpression>
+#include <QString>
+
+namespace
+{
+    /**
+     * @brief Class, that describes parser of regular
+     * expression pattern. It calculates characters,
+     * that match may start with. Unsupported syntax
+     * makes parsing fail.
+     */
+    class FirstCharactersParser
+    {
+    public:
+
+        FirstCharactersParser(const QString& pattern, bool caseInsensitive) :
+            m_pattern(pattern),
+            m_position(0),
+            m_caseInsensitive(caseInsensitive),
+            m_failed(false)
+        {}
+
+        QCharacterSet parse()
+        {
+            auto node = parseAlternation();
+
+            // Empty match is possible or there is
+            // unbalanced parenthesis
+            if (m_failed ||
+                node.nullable ||
+                m_position != m_pattern.size())
+            {
+                return QCharacterSet::all();
+            }
+
+            return node.first;
+        }
+
+    private:
+
+        /**
+         * @brief Structure, that describes
+         * parsed part of pattern.
+         */
+        struct Node
+        {
+            QCharacterSet first;
+            bool nullable;
+        };
+
+        bool atEnd() const
+        {
+            return m_position >= m_pattern.size();
+        }
+
+        bool consume(QChar character)
+        {
+            if (atEnd() || m_pattern[m_position] != character)
+            {
+                return false;
+            }
+
+            ++m_position;
+            return true;
+        }
+
+        Node parseAlternation()
+        {
+            Node result = {QCharacterSet(), false};
+
+            do
+            {
+                auto node = parseSequence();
+                result.first.unite(node.first);
+                result.nullable = result.nullable || node.nullable;
+            }
+            while (!m_failed && consume('|'));
+
+            return result;
+        }
+
+        Node parseSequence()
+        {
+            Node result = {QCharacterSet(), true};
+
+            while (!m_failed &&
+                   !atEnd() &&
+                   m_pattern[m_position] != '|' &&
+                   m_pattern[m_position] != ')')
+            {
+                auto atom = parseAtom();
+
+                if (parseQuantifier())
+                {
+                    atom.nullable = true;
+                }
+
+                // Atom is reachable from sequence start
+                if (result.nullable)
+                {
+                    result.first.unite(atom.first);
+                }
+
+                result.nullable = result.nullable && atom.nullable;
+            }
+
+            return result;
+        }
+
+        Node parseAtom()
+        {
+            auto character = m_pattern[m_position++];
+
+            if (character == '(')
+            {
+                return parseGroup();
+            }
+
+            if (character == '[')
+            {
+                return {parseClass(), false};
+            }
+
+            if (character == '.')
+            {
+                return {QCharacterSet::all(), false};
+            }
+
+            if (character == '^' ||
+                character == '$')
+            {
+                return {QCharacterSet(), true};
+            }
+
+            if (character == '*' ||
+                character == '+' ||
+                character == '?')
+            {
+                m_failed = true;
+                return {QCharacterSet(), true};
+            }
+
+            QCharacterSet result;
+
+            if (character == '\\')
+            {
+                if (atEnd())
+                {
+                    m_failed = true;
+                    return {result, true};
+                }
+
+                // Zero width assertions
+                switch (m_pattern[m_position].unicode())
+                {
+                case 'b':
+                case 'B':
+                case 'A':
+                case 'z':
+                case 'Z':
+                case 'G':
+                    ++m_position;
+                    return {result, true};
+                }
+
+                parseEscape(result);
+                return {result, false};
+            }
+
+            insertLiteral(result, character);
+            return {result, false};
+        }
+
+        Node parseGroup()
+        {
+            bool assertion = false;
+
+            if (consume('?'))
+            {
+                if (consume(':'))
+                {
+                    // Non capturing group
+                }
+                else if (consume('=') || consume('!'))
+                {
+                    assertion = true;
+                }
+                else if (m_pattern.midRef(m_position, 2) == "<=" ||
+                         m_pattern.midRef(m_position, 2) == "<!")
+                {
+                    m_position += 2;
+                    assertion = true;
+                }
+                else if (consume('<') ||
+                         (consume('P') && consume('<')))
+                {
+                    skipGroupName('>');
+                }
+                else if (consume('\''))
+                {
+                    skipGroupName('\'');
+                }
+                else
+                {
+                    // Options, recursion, conditions, etc.
+                    m_failed = true;
+                }
+            }
+
+            if (m_failed)
+            {
+                return {QCharacterSet(), true};
+            }
+
+            auto node = parseAlternation();
+
+            if (!consume(')'))
+            {
+                m_failed = true;
+            }
+
+            if (assertion)
+            {
+                return {QCharacterSet(), true};
+            }
+
+            return node;
+        }
+
+        void skipGroupName(QChar terminator)
+        {
+            auto end = m_pattern.indexOf(terminator, m_position);
+
+            if (end < 0)
+            {
+                m_failed = true;
+                return;
+            }
+
+            m_position = end + 1;
+        }
+
+        /**
+         * @brief Method for parsing quantifier.
+         * @return Is atom optional.
+         */
+        bool parseQuantifier()
+        {
+            bool optional = false;
+
+            if (consume('*') || consume('?'))
+            {
+                optional = true;
+            }
+            else if (consume('+'))
+            {
+                optional = false;
+            }
+            else if (!atEnd() && m_pattern[m_position] == '{')
+            {
+                // Not a quantifier, if it's not "{n}",
+                // "{n,}" or "{n,m}"
+                static const QRegularExpression quantifier(R"(\{(\d+)(,\d*)?\})");
+
+                auto match = quantifier.match(
+                    m_pattern,
+                    m_position,
+                    QRegularExpression::NormalMatch,
+                    QRegularExpression::AnchoredMatchOption
+                );
+
+                if (!match.hasMatch())
+                {
+                    return false;
+                }
+
+                m_position += match.capturedLength();
+                optional = match.capturedRef(1).toInt() == 0;
+            }
+            else
+            {
+                return false;
+            }
+
+            // Lazy and possessive quantifiers
+            if (!consume('?'))
+            {
+                consume('+');
+            }
+
+            return optional;
+        }
+
+        QCharacterSet parseClass()
+        {
+            QCharacterSet result;
+
+            // Negated class matches nearly everything
+            bool negated = consume('^');
+            bool firstItem = true;
+
+            while (!m_failed && !atEnd())
+            {
+                auto character = m_pattern[m_position++];
+
+                if (character == ']' && !firstItem)
+                {
+                    return negated ? QCharacterSet::all() : result;
+                }
+
+                firstItem = false;
+
+                // POSIX classes
+                if (character == '[' && consume(':'))
+                {
+                    m_failed = true;
+                    return result;
+                }
+
+                if (character == '\\')
+                {
+                    if (!parseClassEscape(result, character))
+                    {
+                        continue;
+                    }
+                }
+
+                // Range
+                if (m_position + 1 < m_pattern.size() &&
+                    m_pattern[m_position] == '-' &&
+                    m_pattern[m_position + 1] != ']')
+                {
+                    ++m_position;
+
+                    auto last = m_pattern[m_position++];
+
+                    if (last == '\\' &&
+                        !parseClassEscape(result, last))
+                    {
+                        // Range can't end with class like \d
+                        m_failed = true;
+                        return result;
+                    }
+
+                    insertRange(result, character, last);
+                    continue;
+                }
+
+                insertLiteral(result, character);
+            }
+
+            // There is no closing bracket
+            m_failed = true;
+            return result;
+        }
+
+        /**
+         * @brief Method for parsing escape inside
+         * of class.
+         * @param set Set for escaped classes.
+         * @param literal Escaped character.
+         * @return Is escape a single character.
+         */
+        bool parseClassEscape(QCharacterSet& set, QChar& literal)
+        {
+            QCharacterSet escaped;
+
+            if (!parseEscape(escaped, &literal))
+            {
+                set.unite(escaped);
+                return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Method for parsing escape sequence
+         * after backslash.
+         * @param set Set for escaped characters.
+         * @param literal Optional pointer for single
+         * escaped character. If it's null, single
+         * character is added to set.
+         * @return Is escape a single character.
+         */
+        bool parseEscape(QCharacterSet& set, QChar* literal=nullptr)
+        {
+            if (atEnd())
+            {
+                m_failed = true;
+                return false;
+            }
+
+            auto character = m_pattern[m_position++];
+
+            // Non ASCII characters are always added,
+            // because Unicode properties may be enabled
+            switch (character.unicode())
+            {
+            case 'd':
+                set.insert('0', '9');
+                set.insert(QChar(0x80), QChar(0xFFFF));
+                return false;
+
+            case 'w':
+                set.insert('a', 'z');
+                set.insert('A', 'Z');
+                set.insert('0', '9');
+                set.insert('_');
+                set.insert(QChar(0x80), QChar(0xFFFF));
+                return false;
+
+            case 's':
+                set.insert('\t', '\r');
+                set.insert(' ');
+                set.insert(QChar(0x80), QChar(0xFFFF));
+                return false;
+
+            case 'n': character = '\n';   break;
+            case 't': character = '\t';   break;
+            case 'r': character = '\r';   break;
+            case 'f': character = '\f';   break;
+            case 'v': character = '\v';   break;
+            case 'a': character = '\a';   break;
+            case 'e': character = '\x1b'; break;
+
+            default:
+                // Hexadecimal, Unicode properties,
+                // back references, etc.
+                if (character.isLetterOrNumber())
+                {
+                    m_failed = true;
+                    return false;
+                }
+            }
+
+            if (literal)
+            {
+                *literal = character;
+            }
+            else
+            {
+                insertLiteral(set, character);
+            }
+
+            return true;
+        }
+
+        void insertLiteral(QCharacterSet& set, QChar character)
+        {
+            set.insert(character);
+
+            if (m_caseInsensitive)
+            {
+                set.insert(character.toLower());
+                set.insert(character.toUpper());
+            }
+        }
+
+        void insertRange(QCharacterSet& set, QChar first, QChar last)
+        {
+            set.insert(first, last);
+
+            if (!m_caseInsensitive)
+            {
+                return;
+            }
+
+            for (auto character = first.unicode();
+                 character <= last.unicode() && character < 0x80;
+                 ++character)
+            {
+                insertLiteral(set, QChar(character));
+            }
+        }
+
+        const QString& m_pattern;
+        int m_position;
+        bool m_caseInsensitive;
+        bool m_failed;
+    };
+}
+
+QCharacterSet::QCharacterSet() :
+    m_ascii{0, 0},
+    m_other(false)
+{
+
+}
+
+QCharacterSet QCharacterSet::all()
+{
+    QCharacterSet result;
+
+    result.m_ascii[0] = ~quint64(0);
+    result.m_ascii[1] = ~quint64(0);
+    result.m_other = true;
+
+    return result;
+}
+
+QCharacterSet QCharacterSet::fromText(const QString& text)
+{
+    quint64 low = 0;
+    quint64 high = 0;
+    ushort other = 0;
+
+    // Branchless, so compiler can vectorize it
+    auto data = reinterpret_cast<const ushort*>(text.constData());
+    auto size = text.size();
+
+    for (int i = 0; i < size; ++i)
+    {
+        auto character = data[i];
+        auto bit = quint64(1) << (character & 63);
+
+        low  |= (character < 64) ? bit : 0;
+        high |= (character >= 64 && character < 128) ? bit : 0;
+        other |= character & 0xFF80;
+    }
+
+    QCharacterSet result;
+
+    result.m_ascii[0] = low;
+    result.m_ascii[1] = high;
+    result.m_other = other != 0;
+
+    return result;
+}
+
+QCharacterSet QCharacterSet::firstCharacters(const QRegularExpression& expression)
+{
+    auto options = expression.patternOptions();
+
+    if (!expression.isValid() ||
+        (options & QRegularExpression::ExtendedPatternSyntaxOption))
+    {
+        return all();
+    }
+
+    FirstCharactersParser parser(
+        expression.pattern(),
+        options & QRegularExpression::CaseInsensitiveOption
+    );
+
+    return parser.parse();
+}
+
+void QCharacterSet::insert(QChar character)
+{
+    insert(character, character);
+}
+
+void QCharacterSet::insert(QChar first, QChar last)
+{
+    auto from = first.unicode();
+    auto to = last.unicode();
+
+    if (to >= 0x80)
+    {
+        m_other = true;
+        to = 0x7F;
+    }
+
+    for (auto character = from; character <= to; ++character)
+    {
+        m_ascii[character >> 6] |= quint64(1) << (character & 63);
+    }
+}
+
+void QCharacterSet::unite(const QCharacterSet& other)
+{
+    m_ascii[0] |= other.m_ascii[0];
+    m_ascii[1] |= other.m_ascii[1];
+    m_other = m_other || other.m_other;
+}
+
+QCharacterSet QCharacterSet::inverted() const
+{
+    QCharacterSet result;
+
+    result.m_ascii[0] = ~m_ascii[0];
+    result.m_ascii[1] = ~m_ascii[1];
+    result.m_other = !m_other;
+
+    return result;
+}
+
+bool QCharacterSet::intersects(const QCharacterSet& other) const
+{
+    return (m_ascii[0] & other.m_ascii[0]) ||
+           (m_ascii[1] & other.m_ascii[1]) ||
+           (m_other && other.m_other);
+}
+
+bool QCharacterSet::contains(QChar character) const
+{
+    auto code = character.unicode();
+
+    if (code >= 0x80)
+    {
+        return m_other;
+    }
+
+    return m_ascii[code >> 6] & (quint64(1) << (code & 63));
+}
+
+bool QCharacterSet::isEmpty() const
+{
+    return !m_ascii[0] && !m_ascii[1] && !m_other;
+}
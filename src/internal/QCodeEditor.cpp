@@ -3,7 +3,11 @@
 #include <QSyntaxStyle>
 #include <QCodeEditor>
 #include <QStyleSyntaxHighlighter>
-#include <QFramedTextAttribute>
+#include <QBracketIndex>
+#include <QOccurrenceOverlay>
+#include <QFileLoader>
+#include <QMinimap>
+#include <QIdentifierCompleter>
 #include <QCXXHighlighter>
 
 
@@ -19,6 +23,9 @@
 #include <QAbstractItemView>
 #include <QShortcut>
 #include <QMimeData>
+#include <QPainter>
+#include <QTimer>
+#include <QFileInfo>
 
 static QVector<QPair<QString, QString>> parentheses = {
     {"(", ")"},
@@ -31,31 +38,36 @@ QCodeEditor::QCodeEditor(QWidget* widget) :
     QTextEdit(widget),
     m_highlighter(nullptr),
     m_syntaxStyle(nullptr),
+    m_syntaxStyleConnection(),
     m_lineNumberArea(new QLineNumberArea(this)),
     m_completer(nullptr),
-    m_framedAttribute(new QFramedTextAttribute(this)),
+    m_occurrenceOverlay(new QOccurrenceOverlay(this)),
+    m_fileLoader(new QFileLoader(this)),
     m_autoIndentation(true),
     m_autoParentheses(true),
     m_replaceTab(true),
-    m_tabReplace(QString(4, ' '))
+    m_tabReplace(QString(4, ' ')),
+    m_largeFileMode(false),
+    m_largeFileThreshold(4 * 1024 * 1024),
+    m_lineWrapMode(lineWrapMode()),
+    m_highlighterSwitched(false),
+    m_largeFileModeScheduled(false),
+    m_undoRedoEnabled(true),
+    m_readOnly(false),
+    m_foldingTree(),
+    m_foldingEnabled(true),
+    m_foldingUpdateScheduled(false),
+    m_minimap(new QMinimap(this)),
+    m_minimapEnabled(false)
 {
-    initDocumentLayoutHandlers();
+    m_minimap->hide();
+
     initFont();
     performConnections();
 
     setSyntaxStyle(QSyntaxStyle::defaultStyle());
 }
 
-void QCodeEditor::initDocumentLayoutHandlers()
-{
-    document()
-        ->documentLayout()
-        ->registerHandler(
-            QFramedTextAttribute::type(),
-            m_framedAttribute
-        );
-}
-
 void QCodeEditor::initFont()
 {
     auto fnt = QFontDatabase::systemFont(QFontDatabase::FixedFont);
@@ -77,7 +89,10 @@ void QCodeEditor::performConnections()
     connect(
         verticalScrollBar(),
         &QScrollBar::valueChanged,
-        [this](int){ m_lineNumberArea->update(); }
+        [this](int)
+        {
+            updateVisibleBlocks();
+        }
     );
 
     connect(
@@ -87,19 +102,90 @@ void QCodeEditor::performConnections()
         &QCodeEditor::updateExtraSelection
     );
 
+    connect(
+        this,
+        &QTextEdit::cursorPositionChanged,
+        this,
+        &QCodeEditor::revealCursorBlock
+    );
+
     connect(
         this,
         &QTextEdit::selectionChanged,
         this,
         &QCodeEditor::onSelectionChanged
     );
+
+    connect(
+        document(),
+        &QTextDocument::contentsChange,
+        this,
+        [this](int position, int, int charsAdded)
+        {
+            // Highlighter is connected to document after
+            // editor, so it processes inserted text after
+            // switching to lazy highlighting
+            if (charsAdded > 0)
+            {
+                checkLargeFileThreshold();
+            }
+
+            auto doc = document();
+            auto last = doc->blockCount() - 1;
+            auto first = doc->findBlock(position).blockNumber();
+            auto end = doc->findBlock(position + charsAdded).blockNumber();
+
+            first = first < 0 ? last : first;
+            end = end < 0 ? last : end;
+
+            invalidateFolding(first, end);
+            m_minimap->invalidateBlocks(first, end);
+        }
+    );
+
+    connect(
+        m_fileLoader,
+        &QFileLoader::progress,
+        this,
+        &QCodeEditor::openFileProgress
+    );
+
+    connect(
+        m_fileLoader,
+        &QFileLoader::finished,
+        this,
+        [this](bool completed)
+        {
+            document()->setUndoRedoEnabled(m_undoRedoEnabled);
+            setReadOnly(m_readOnly);
+
+            emit openFileFinished(completed);
+        }
+    );
+
+    connect(
+        m_occurrenceOverlay,
+        &QOccurrenceOverlay::totalCountChanged,
+        this,
+        &QCodeEditor::occurrenceCountChanged
+    );
 }
 
 void QCodeEditor::setHighlighter(QStyleSyntaxHighlighter* highlighter)
 {
     if (m_highlighter)
     {
+        disconnect(m_highlighter, nullptr, this, nullptr);
         m_highlighter->setDocument(nullptr);
+
+        // Returning mode, that was changed by large file mode
+        if (m_highlighterSwitched)
+        {
+            m_highlighter->setHighlightMode(QStyleSyntaxHighlighter::HighlightMode::Synchronous);
+            m_highlighterSwitched = false;
+        }
+
+        m_highlighter->setOffscreenFormattingEnabled(true);
     }
 
     m_highlighter = highlighter;
@@ -107,16 +193,59 @@ void QCodeEditor::setHighlighter(QStyleSyntaxHighlighter* highlighter)
     if (m_highlighter)
     {
         m_highlighter->setSyntaxStyle(m_syntaxStyle);
+        updateLargeFileMode();
+
+        // Highlighter finds states and brackets
+        // outside of strings and comments
+        connect(
+            m_highlighter,
+            &QStyleSyntaxHighlighter::blockHighlighted,
+            this,
+            [this](int blockNumber)
+            {
+                invalidateFolding(blockNumber, blockNumber);
+                m_minimap->invalidateBlocks(blockNumber, blockNumber);
+            }
+        );
+
+        connect(
+            m_highlighter,
+            &QStyleSyntaxHighlighter::blocksRestyled,
+            m_minimap,
+            &QMinimap::invalidateBlocks
+        );
+
         m_highlighter->setDocument(document());
     }
+
+    updateVisibleBlocks();
 }
 
 void QCodeEditor::setSyntaxStyle(QSyntaxStyle* style)
 {
+    if (m_syntaxStyle != style)
+    {
+        disconnect(m_syntaxStyleConnection);
+
+        // Colors, cached from style, are
+        // updated when it's loaded again
+        if (style)
+        {
+            m_syntaxStyleConnection = connect(
+                style,
+                &QSyntaxStyle::changed,
+                this,
+                [this]()
+                { setSyntaxStyle(m_syntaxStyle); }
+            );
+        }
+    }
+
     m_syntaxStyle = style;
 
-    m_framedAttribute->setSyntaxStyle(m_syntaxStyle);
+    m_occurrenceOverlay->setSyntaxStyle(m_syntaxStyle);
     m_lineNumberArea->setSyntaxStyle(m_syntaxStyle);
+    m_minimap->setSyntaxStyle(m_syntaxStyle);
 
     if (m_highlighter)
     {
@@ -130,7 +259,7 @@ void QCodeEditor::updateStyle()
 {
     if (m_highlighter)
     {
-        m_highlighter->rehighlight();
+        m_highlighter->restyle();
     }
 
     if (m_syntaxStyle)
@@ -176,19 +305,311 @@ void QCodeEditor::onSelectionChanged()
     cursor.movePosition(QTextCursor::MoveOperation::Left);
     cursor.select(QTextCursor::SelectionType::WordUnderCursor);
 
-    QSignalBlocker blocker(this);
-    m_framedAttribute->clear(cursor);
-
+    // Framing occurrences of selected word
     if (selected.size() > 1 &&
         cursor.selectedText() == selected)
     {
-        auto backup = textCursor();
+        m_occurrenceOverlay->setText(selected);
+    }
+    else
+    {
+        m_occurrenceOverlay->setText(QString());
+    }
+}
+
+void QCodeEditor::setFoldingEnabled(bool enabled)
+{
+    if (m_foldingEnabled == enabled)
+    {
+        return;
+    }
+
+    if (!enabled)
+    {
+        unfoldAll();
+        m_foldingTree.clear();
+    }
+
+    m_foldingEnabled = enabled;
+
+    if (m_foldingEnabled)
+    {
+        m_foldingTree.invalidateAll();
+        scheduleFoldingUpdate();
+    }
+
+    updateLineNumberAreaWidth(0);
+    updateLineGeometry();
+}
+
+bool QCodeEditor::foldingEnabled() const
+{
+    return m_foldingEnabled;
+}
+
+void QCodeEditor::setIndentationFolding(bool enabled)
+{
+    m_foldingTree.setIndentationBased(enabled);
+    scheduleFoldingUpdate();
+}
+
+bool QCodeEditor::indentationFolding() const
+{
+    return m_foldingTree.isIndentationBased();
+}
+
+bool QCodeEditor::toggleFold(int blockNumber)
+{
+    updateFolding();
+
+    auto region = m_foldingTree.regionAt(blockNumber);
+
+    if (region.start < 0)
+    {
+        return false;
+    }
+
+    m_foldingTree.setFolded(blockNumber, !region.folded);
+    updateFoldedBlocks(region.start + 1, region.end);
+
+    m_lineNumberArea->update();
+
+    return true;
+}
+
+bool QCodeEditor::isFolded(int blockNumber) const
+{
+    auto region = m_foldingTree.regionAt(blockNumber);
+
+    return region.start >= 0 && region.folded;
+}
+
+void QCodeEditor::foldAll()
+{
+    updateFolding();
+
+    m_foldingTree.setAllFolded(true);
+    updateFoldedBlocks(0, document()->blockCount() - 1);
+
+    m_lineNumberArea->update();
+}
+
+void QCodeEditor::unfoldAll()
+{
+    updateFolding();
+
+    m_foldingTree.setAllFolded(false);
+    updateFoldedBlocks(0, document()->blockCount() - 1);
+
+    m_lineNumberArea->update();
+}
+
+const QFoldingTree& QCodeEditor::foldingTree() const
+{
+    return m_foldingTree;
+}
+
+void QCodeEditor::setMinimapEnabled(bool enabled)
+{
+    if (m_minimapEnabled == enabled)
+    {
+        return;
+    }
+
+    m_minimapEnabled = enabled;
+
+    // Tiles of hidden minimap only take memory
+    m_minimap->invalidateAll();
+    m_minimap->setVisible(m_minimapEnabled);
+
+    updateLineNumberAreaWidth(0);
+    updateLineGeometry();
+}
+
+bool QCodeEditor::minimapEnabled() const
+{
+    return m_minimapEnabled;
+}
+
+void QCodeEditor::invalidateFolding(int firstBlock, int lastBlock)
+{
+    if (!m_foldingEnabled)
+    {
+        return;
+    }
+
+    m_foldingTree.invalidate(firstBlock, lastBlock, document()->blockCount());
+    scheduleFoldingUpdate();
+}
+
+void QCodeEditor::scheduleFoldingUpdate()
+{
+    if (m_foldingUpdateScheduled)
+    {
+        return;
+    }
+
+    m_foldingUpdateScheduled = true;
+    QTimer::singleShot(0, this, &QCodeEditor::updateFolding);
+}
+
+void QCodeEditor::updateFolding()
+{
+    m_foldingUpdateScheduled = false;
+
+    if (!m_foldingEnabled ||
+        !m_foldingTree.isDirty())
+    {
+        return;
+    }
+
+    auto hadFoldedRegions = m_foldingTree.hasFoldedRegions();
+    auto changed = m_foldingTree.update(document());
+
+    // Removed regions may leave hidden blocks
+    if (hadFoldedRegions ||
+        m_foldingTree.hasFoldedRegions())
+    {
+        updateFoldedBlocks(changed.first, changed.second);
+    }
+
+    m_lineNumberArea->update();
+}
+
+void QCodeEditor::updateFoldedBlocks(int first, int last)
+{
+    auto doc = document();
+    auto ranges = m_foldingTree.hiddenRanges(first, last);
+    auto range = ranges.begin();
+
+    auto dirtyFrom = -1;
+    auto dirtyTo = -1;
+
+    auto number = first;
+    for (auto block = doc->findBlockByNumber(first);
+         block.isValid() && number <= last;
+         block = block.next(), ++number)
+    {
+        while (range != ranges.end() &&
+               range->second < number)
+        {
+            ++range;
+        }
+
+        auto visible = range == ranges.end() ||
+                       range->first > number;
+
+        if (block.isVisible() == visible)
+        {
+            continue;
+        }
+
+        block.setVisible(visible);
+
+        if (dirtyFrom < 0)
+        {
+            dirtyFrom = block.position();
+        }
+
+        dirtyTo = block.position() + block.length();
+    }
+
+    if (dirtyFrom < 0)
+    {
+        return;
+    }
+
+    // Hidden blocks are skipped by layout
+    doc->markContentsDirty(dirtyFrom, dirtyTo - dirtyFrom);
+
+    // Cursor can't stay in hidden block
+    auto cursor = textCursor();
+    auto block = cursor.block();
+
+    while (block.isValid() && !block.isVisible())
+    {
+        block = block.previous();
+    }
+
+    if (block.isValid() &&
+        block != cursor.block())
+    {
+        cursor.setPosition(block.position() + block.length() - 1);
+        setTextCursor(cursor);
+    }
+
+    viewport()->update();
+    updateVisibleBlocks();
+}
+
+void QCodeEditor::revealCursorBlock()
+{
+    auto block = textCursor().block();
+
+    if (block.isVisible() ||
+        !m_foldingTree.hasFoldedRegions())
+    {
+        return;
+    }
+
+    auto range = m_foldingTree.unfoldEnclosing(block.blockNumber());
+
+    updateFoldedBlocks(range.first, range.second);
+
+    m_lineNumberArea->update();
+}
+
+int QCodeEditor::occurrenceCount() const
+{
+    return m_occurrenceOverlay->totalCount();
+}
+
+bool QCodeEditor::openFile(const QString& path)
+{
+    cancelOpenFile();
+
+    QFileInfo info(path);
+
+    if (!info.isFile() ||
+        !info.isReadable())
+    {
+        return false;
+    }
 
-        // Perform search selecting
-        handleSelectionQuery(cursor);
+    // Document is kept, if file can't be opened
+    if (!m_fileLoader->open(path))
+    {
+        return false;
+    }
 
-        setTextCursor(backup);
+    // Switching before layout of first chunk
+    if (m_largeFileThreshold > 0 &&
+        m_fileLoader->size() > m_largeFileThreshold)
+    {
+        setLargeFileMode(true);
     }
+
+    m_undoRedoEnabled = document()->isUndoRedoEnabled();
+    m_readOnly = isReadOnly();
+
+    // Loaded text is not an undoable edit
+    clear();
+    document()->setUndoRedoEnabled(false);
+    setReadOnly(true);
+
+    m_fileLoader->start(document());
+
+    return true;
+}
+
+void QCodeEditor::cancelOpenFile()
+{
+    m_fileLoader->cancel();
+}
+
+bool QCodeEditor::isOpeningFile() const
+{
+    return m_fileLoader->isLoading();
 }
 
 void QCodeEditor::resizeEvent(QResizeEvent* e)
@@ -196,6 +617,18 @@ void QCodeEditor::resizeEvent(QResizeEvent* e)
     QTextEdit::resizeEvent(e);
 
     updateLineGeometry();
+    updateVisibleBlocks();
+}
+
+void QCodeEditor::scrollContentsBy(int dx, int dy)
+{
+    QTextEdit::scrollContentsBy(dx, dy);
+
+    if (dy != 0)
+    {
+        m_lineNumberArea->scroll(0, dy);
+        m_minimap->update();
+    }
 }
 
 void QCodeEditor::updateLineGeometry()
@@ -208,11 +641,39 @@ void QCodeEditor::updateLineGeometry()
               cr.height()
         )
     );
+
+    auto viewportRect = viewport()->geometry();
+    m_minimap->setGeometry(
+        QRect(viewportRect.right() + 1,
+              viewportRect.top(),
+              m_minimap->sizeHint().width(),
+              viewportRect.height()
+        )
+    );
+}
+
+void QCodeEditor::updateVisibleBlocks()
+{
+    if (m_highlighter == nullptr ||
+        m_highlighter->highlightMode() == QStyleSyntaxHighlighter::HighlightMode::Synchronous)
+    {
+        return;
+    }
+
+    auto first = getFirstVisibleBlock();
+    auto last = cursorForPosition(viewport()->rect().bottomLeft()).blockNumber();
+
+    m_highlighter->setVisibleBlocks(first, last);
 }
 
 void QCodeEditor::updateLineNumberAreaWidth(int)
 {
-    setViewportMargins(m_lineNumberArea->sizeHint().width(), 0, 0, 0);
+    setViewportMargins(
+        m_lineNumberArea->sizeHint().width(),
+        0,
+        m_minimapEnabled ? m_minimap->sizeHint().width() : 0,
+        0
+    );
 }
 
 void QCodeEditor::updateLineNumberArea(const QRect& rect)
@@ -231,20 +692,6 @@ void QCodeEditor::updateLineNumberArea(const QRect& rect)
     }
 }
 
-void QCodeEditor::handleSelectionQuery(QTextCursor cursor)
-{
-
-    auto searchIterator = cursor;
-    searchIterator.movePosition(QTextCursor::Start);
-    searchIterator = document()->find(cursor.selectedText(), searchIterator);
-    while (searchIterator.hasSelection())
-    {
-        m_framedAttribute->frame(searchIterator);
-
-        searchIterator = document()->find(cursor.selectedText(), searchIterator);
-    }
-}
-
 void QCodeEditor::updateExtraSelection()
 {
     QList<QTextEdit::ExtraSelection> extra;
@@ -257,99 +704,109 @@ void QCodeEditor::updateExtraSelection()
 
 void QCodeEditor::highlightParenthesis(QList<QTextEdit::ExtraSelection>& extraSelection)
 {
-    auto currentSymbol = charUnderCursor();
-    auto prevSymbol = charUnderCursor(-1);
+    auto position = matchedBracketPosition();
 
-    for (auto& pair : parentheses)
+    if (position < 0)
     {
-        int direction;
+        return;
+    }
 
-        QChar counterSymbol;
-        QChar activeSymbol;
-        auto position = textCursor().position();
+    auto match = QBracketIndex::findMatchingBracket(document(), position);
 
-        if (pair.first == currentSymbol)
-        {
-            direction = 1;
-            counterSymbol = pair.second[0];
-            activeSymbol = currentSymbol;
-        }
-        else if (pair.second == prevSymbol)
-        {
-            direction = -1;
-            counterSymbol = pair.first[0];
-            activeSymbol = prevSymbol;
-            position--;
-        }
-        else
+    // Found
+    if (match >= 0)
+    {
+        auto format = m_syntaxStyle->getFormat("Parentheses");
+
+        for (auto bracket : {match, position})
         {
-            continue;
+            ExtraSelection selection{};
+
+            selection.format = format;
+            selection.cursor = textCursor();
+            selection.cursor.setPosition(bracket);
+            selection.cursor.setPosition(
+                bracket + 1,
+                QTextCursor::MoveMode::KeepAnchor
+            );
+
+            extraSelection.append(selection);
         }
+    }
+}
 
-        auto counter = 1;
+int QCodeEditor::matchedBracketPosition()
+{
+    auto position = textCursor().position();
 
-        while (counter != 0 &&
-               position > 0 &&
-               position < (document()->characterCount() - 1))
-        {
-            // Moving position
-            position += direction;
+    // Opening bracket after cursor or closing before it
+    if (QBracketIndex::isOpening(charUnderCursor()))
+    {
+        return position;
+    }
 
-            auto character = document()->characterAt(position);
-            // Checking symbol under position
-            if (character == activeSymbol)
-            {
-                ++counter;
-            }
-            else if (character == counterSymbol)
-            {
-                --counter;
-            }
-        }
+    auto previous = charUnderCursor(-1);
+    if (QBracketIndex::isBracket(previous) &&
+        !QBracketIndex::isOpening(previous))
+    {
+        return position - 1;
+    }
 
-        auto format = m_syntaxStyle->getFormat("Parentheses");
+    return -1;
+}
 
-        // Found
-        if (counter == 0)
-        {
-            ExtraSelection selection{};
+bool QCodeEditor::jumpToMatchingBracket()
+{
+    auto position = matchedBracketPosition();
 
-            auto directionEnum =
-                 direction < 0 ?
-                 QTextCursor::MoveOperation::Left
-                 :
-                 QTextCursor::MoveOperation::Right;
+    if (position < 0)
+    {
+        return false;
+    }
 
-            selection.format = format;
-            selection.cursor = textCursor();
-            selection.cursor.clearSelection();
-            selection.cursor.movePosition(
-                directionEnum,
-                QTextCursor::MoveMode::MoveAnchor,
-                std::abs(textCursor().position() - position)
-            );
+    auto match = QBracketIndex::findMatchingBracket(document(), position);
 
-            selection.cursor.movePosition(
-                QTextCursor::MoveOperation::Right,
-                QTextCursor::MoveMode::KeepAnchor,
-                1
-            );
+    if (match < 0)
+    {
+        return false;
+    }
 
-            extraSelection.append(selection);
+    // Cursor is placed at the same side of bracket
+    auto cursor = textCursor();
+    cursor.setPosition(
+        position == cursor.position() ?
+        match + 1
+        :
+        match
+    );
+    setTextCursor(cursor);
 
-            selection.cursor = textCursor();
-            selection.cursor.clearSelection();
-            selection.cursor.movePosition(
-                directionEnum,
-                QTextCursor::MoveMode::KeepAnchor,
-                1
-            );
+    return true;
+}
 
-            extraSelection.append(selection);
-        }
+bool QCodeEditor::selectEnclosingScope()
+{
+    auto cursor = textCursor();
+
+    auto opening = QBracketIndex::findEnclosingBracket(document(), cursor.selectionStart());
 
-        break;
+    if (opening < 0)
+    {
+        return false;
     }
+
+    auto closing = QBracketIndex::findMatchingBracket(document(), opening);
+
+    if (closing < 0)
+    {
+        return false;
+    }
+
+    cursor.setPosition(opening);
+    cursor.setPosition(closing + 1, QTextCursor::MoveMode::KeepAnchor);
+    setTextCursor(cursor);
+
+    return true;
 }
 
 void QCodeEditor::highlightCurrentLine(QList<QTextEdit::ExtraSelection>& extraSelection)
@@ -372,40 +829,26 @@ void QCodeEditor::paintEvent(QPaintEvent* e)
 {
     updateLineNumberArea(e->rect());
     QTextEdit::paintEvent(e);
+
+    QPainter painter(viewport());
+    m_occurrenceOverlay->paint(painter, e->rect());
 }
 
 int QCodeEditor::getFirstVisibleBlock()
 {
-    // Detect the first block for which bounding rect - once translated
-    // in absolute coordinated - is contained by the editor's text area
-
-    // Costly way of doing but since "blockBoundingGeometry(...)" doesn't
-    // exists for "QTextEdit"...
-
-    QTextCursor curs = QTextCursor(document());
-    curs.movePosition(QTextCursor::Start);
-    for(int i=0; i < document()->blockCount(); ++i)
+    // Hit test of viewport top lays document out only
+    // up to viewport, unlike bounding rects of blocks,
+    // that are not laid out yet
+    auto first = cursorForPosition(viewport()->rect().topLeft()).blockNumber();
+
+    // Hidden block at viewport top belongs to
+    // folded region, that starts above it
+    if (m_foldingTree.hasFoldedRegions())
     {
-        QTextBlock block = curs.block();
-
-        QRect r1 = viewport()->geometry();
-        QRect r2 = document()
-            ->documentLayout()
-            ->blockBoundingRect(block)
-            .translated(
-                viewport()->geometry().x(),
-                viewport()->geometry().y() - verticalScrollBar()->sliderPosition()
-            ).toRect();
-
-        if (r1.intersects(r2))
-        {
-            return i;
-        }
-
-        curs.movePosition(QTextCursor::NextBlock);
+        first = m_foldingTree.visibleBlock(first);
     }
 
-    return 0;
+    return qMax(0, first);
 }
 
 bool QCodeEditor::proceedCompleterBegin(QKeyEvent *e)
@@ -576,6 +1019,126 @@ bool QCodeEditor::autoIndentation() const
     return m_autoIndentation;
 }
 
+void QCodeEditor::setLargeFileMode(bool enabled)
+{
+    if (m_largeFileMode == enabled)
+    {
+        return;
+    }
+
+    m_largeFileMode = enabled;
+
+    if (m_largeFileMode)
+    {
+        // Every block is laid out as single line
+        m_lineWrapMode = lineWrapMode();
+        setLineWrapMode(LineWrapMode::NoWrap);
+    }
+    else
+    {
+        setLineWrapMode(m_lineWrapMode);
+    }
+
+    updateLargeFileMode();
+}
+
+bool QCodeEditor::largeFileMode() const
+{
+    return m_largeFileMode;
+}
+
+void QCodeEditor::setLargeFileThreshold(int characters)
+{
+    m_largeFileThreshold = characters;
+
+    checkLargeFileThreshold();
+}
+
+int QCodeEditor::largeFileThreshold() const
+{
+    return m_largeFileThreshold;
+}
+
+void QCodeEditor::updateLargeFileMode()
+{
+    updateLargeFileHighlighting(m_largeFileMode);
+    updateVisibleBlocks();
+}
+
+void QCodeEditor::updateLargeFileHighlighting(bool lazy)
+{
+    // Every formatted block is laid out again, so only
+    // visible blocks are formatted in large file mode
+    if (m_highlighter)
+    {
+        m_highlighter->setOffscreenFormattingEnabled(!lazy);
+    }
+
+    if (lazy)
+    {
+        if (m_highlighter &&
+            m_highlighter->grammar() &&
+            m_highlighter->highlightMode() == QStyleSyntaxHighlighter::HighlightMode::Synchronous)
+        {
+            m_highlighter->setHighlightMode(QStyleSyntaxHighlighter::HighlightMode::Lazy);
+            m_highlighterSwitched = true;
+        }
+    }
+    else
+    {
+        if (m_highlighter && m_highlighterSwitched)
+        {
+            m_highlighter->setHighlightMode(QStyleSyntaxHighlighter::HighlightMode::Synchronous);
+        }
+
+        m_highlighterSwitched = false;
+    }
+}
+
+void QCodeEditor::checkLargeFileThreshold()
+{
+    if (m_largeFileMode ||
+        m_largeFileThreshold <= 0 ||
+        document()->characterCount() <= m_largeFileThreshold)
+    {
+        return;
+    }
+
+    // Highlighter has to be lazy, before it processes
+    // inserted text. Line wrapping relayouts whole
+    // document, so it's switched after document
+    // finished notifying about change.
+    updateLargeFileHighlighting(true);
+
+    if (m_largeFileModeScheduled)
+    {
+        return;
+    }
+
+    m_largeFileModeScheduled = true;
+    QTimer::singleShot(0, this, &QCodeEditor::enableLargeFileMode);
+}
+
+void QCodeEditor::enableLargeFileMode()
+{
+    m_largeFileModeScheduled = false;
+
+    if (m_largeFileMode)
+    {
+        return;
+    }
+
+    // Text may be removed since threshold was exceeded
+    if (m_largeFileThreshold <= 0 ||
+        document()->characterCount() <= m_largeFileThreshold)
+    {
+        updateLargeFileHighlighting(false);
+        return;
+    }
+
+    setLargeFileMode(true);
+}
+
 void QCodeEditor::setAutoParentheses(bool enabled)
 {
     m_autoParentheses = enabled;
@@ -613,6 +1176,14 @@ void QCodeEditor::setCompleter(QCompleter *completer)
     if (m_completer)
     {
         disconnect(m_completer, nullptr, this, nullptr);
+
+        auto identifierCompleter = qobject_cast<QIdentifierCompleter*>(m_completer);
+
+        if (identifierCompleter &&
+            identifierCompleter->document() == document())
+        {
+            identifierCompleter->setDocument(nullptr);
+        }
     }
 
     m_completer = completer;
@@ -622,6 +1193,14 @@ void QCodeEditor::setCompleter(QCompleter *completer)
         return;
     }
 
+    // Completing identifiers of this document
+    auto identifierCompleter = qobject_cast<QIdentifierCompleter*>(m_completer);
+
+    if (identifierCompleter)
+    {
+        identifierCompleter->setDocument(document());
+    }
+
     m_completer->setWidget(this);
     m_completer->setCompletionMode(QCompleter::CompletionMode::PopupCompletion);
 
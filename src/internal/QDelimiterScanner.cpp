@@ -0,0 +1,229 @@
+// QCodeEditor
+#include <QDelimiterScanner>
+
+// Qt
+#include <QtAlgorithms>
+
+// std
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define QDELIMITERSCANNER_SSE2
+#   include <emmintrin.h>
+#endif
+
+// AVX2 code is compiled for target attribute and
+// selected at runtime, so library doesn't require AVX2
+#if defined(QDELIMITERSCANNER_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define QDELIMITERSCANNER_AVX2
+#   include <immintrin.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Function for appending positions of
+     * delimiters from comparison mask. Every UTF-16
+     * character has two bits in mask.
+     */
+    inline void appendMask(uint mask, int offset, QVector<int>& positions)
+    {
+        while (mask)
+        {
+            positions.append(offset + static_cast<int>(qCountTrailingZeroBits(mask)) / 2);
+
+            // Both bits of character
+            mask &= mask - 1;
+            mask &= mask - 1;
+        }
+    }
+
+#ifdef QDELIMITERSCANNER_SSE2
+    /**
+     * @brief Function for scanning 8 characters
+     * per iteration.
+     * @return Position of first not scanned character.
+     */
+    int scanSSE2(const ushort* data, int from, int length, QVector<int>& positions)
+    {
+        const auto slash      = _mm_set1_epi16('/');
+        const auto star       = _mm_set1_epi16('*');
+        const auto quote      = _mm_set1_epi16('"');
+        const auto apostrophe = _mm_set1_epi16('\'');
+        const auto hash       = _mm_set1_epi16('#');
+
+        int i = from;
+        for (; i + 8 <= length; i += 8)
+        {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+            auto matches = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi16(chunk, slash),
+                    _mm_cmpeq_epi16(chunk, star)
+                ),
+                _mm_or_si128(
+                    _mm_or_si128(
+                        _mm_cmpeq_epi16(chunk, quote),
+                        _mm_cmpeq_epi16(chunk, apostrophe)
+                    ),
+                    _mm_cmpeq_epi16(chunk, hash)
+                )
+            );
+
+            appendMask(static_cast<uint>(_mm_movemask_epi8(matches)), i, positions);
+        }
+
+        return i;
+    }
+#endif
+
+#ifdef QDELIMITERSCANNER_AVX2
+    /**
+     * @brief Function for scanning 16 characters
+     * per iteration.
+     * @return Position of first not scanned character.
+     */
+    __attribute__((target("avx2")))
+    int scanAVX2(const ushort* data, int from, int length, QVector<int>& positions)
+    {
+        const auto slash      = _mm256_set1_epi16('/');
+        const auto star       = _mm256_set1_epi16('*');
+        const auto quote      = _mm256_set1_epi16('"');
+        const auto apostrophe = _mm256_set1_epi16('\'');
+        const auto hash       = _mm256_set1_epi16('#');
+
+        int i = from;
+        for (; i + 16 <= length; i += 16)
+        {
+            auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+            auto matches = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi16(chunk, slash),
+                    _mm256_cmpeq_epi16(chunk, star)
+                ),
+                _mm256_or_si256(
+                    _mm256_or_si256(
+                        _mm256_cmpeq_epi16(chunk, quote),
+                        _mm256_cmpeq_epi16(chunk, apostrophe)
+                    ),
+                    _mm256_cmpeq_epi16(chunk, hash)
+                )
+            );
+
+            appendMask(static_cast<uint>(_mm256_movemask_epi8(matches)), i, positions);
+        }
+
+        return i;
+    }
+
+    bool hasAVX2()
+    {
+        static const bool result = __builtin_cpu_supports("avx2");
+        return result;
+    }
+#endif
+}
+
+QDelimiterScanner::QDelimiterScanner(const QString& text) :
+    m_text(text),
+    m_positions()
+{
+    scan(text.constData(), text.size(), m_positions);
+}
+
+bool QDelimiterScanner::isDelimiter(QChar character)
+{
+    switch (character.unicode())
+    {
+    case '/':
+    case '*':
+    case '"':
+    case '\'':
+    case '#':
+        return true;
+    }
+
+    return false;
+}
+
+void QDelimiterScanner::scan(const QChar* data, int length, QVector<int>& positions)
+{
+    auto characters = reinterpret_cast<const ushort*>(data);
+
+    int i = 0;
+
+#ifdef QDELIMITERSCANNER_AVX2
+    if (hasAVX2())
+    {
+        i = scanAVX2(characters, i, length, positions);
+    }
+#endif
+
+#ifdef QDELIMITERSCANNER_SSE2
+    i = scanSSE2(characters, i, length, positions);
+#endif
+
+    // Tail
+    for (; i < length; ++i)
+    {
+        if (isDelimiter(data[i]))
+        {
+            positions.append(i);
+        }
+    }
+}
+
+bool QDelimiterScanner::isEmpty() const
+{
+    return m_positions.isEmpty();
+}
+
+const QVector<int>& QDelimiterScanner::positions() const
+{
+    return m_positions;
+}
+
+int QDelimiterScanner::indexOf(QChar delimiter, int from) const
+{
+    auto data = m_text.constData();
+
+    for (int i = lowerBound(from); i < m_positions.size(); ++i)
+    {
+        if (data[m_positions[i]] == delimiter)
+        {
+            return m_positions[i];
+        }
+    }
+
+    return -1;
+}
+
+int QDelimiterScanner::indexOf(QChar first, QChar second, int from) const
+{
+    auto data = m_text.constData();
+
+    // Both characters are delimiters, so they
+    // are neighbours in positions
+    for (int i = lowerBound(from); i + 1 < m_positions.size(); ++i)
+    {
+        auto position = m_positions[i];
+
+        if (data[position] == first &&
+            m_positions[i + 1] == position + 1 &&
+            data[position + 1] == second)
+        {
+            return position;
+        }
+    }
+
+    return -1;
+}
+
+int QDelimiterScanner::lowerBound(int from) const
+{
+    return static_cast<int>(
+        std::lower_bound(m_positions.begin(), m_positions.end(), from) - m_positions.begin()
+    );
+}
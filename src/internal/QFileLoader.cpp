@@ -0,0 +1,254 @@
+// QCodeEditor
+#include <QFileLoader>
+
+// Qt
+#include <QElapsedTimer>
+#include <QTextCodec>
+#include <QTextCursor>
+#include <QTimer>
+
+// First chunk is small, so first screen
+// of text is shown immediately.
+static const qint64 firstChunkSize = 64 * 1024;
+static const qint64 chunkSize = 1024 * 1024;
+
+// Duration of loading between event loop iterations.
+static const int sliceMilliseconds = 16;
+
+QFileLoader::QFileLoader(QObject* parent) :
+    QObject(parent),
+    m_file(),
+    m_map(nullptr),
+    m_offset(0),
+    m_size(0),
+    m_decoder(),
+    m_carriageReturn(),
+    m_document(),
+    m_documentConnection(),
+    m_loading(false),
+    m_appending(false),
+    m_chunksScheduled(false)
+{
+
+}
+
+QFileLoader::~QFileLoader()
+{
+    if (m_map)
+    {
+        m_file.unmap(m_map);
+    }
+}
+
+bool QFileLoader::open(const QString& path)
+{
+    cancel();
+    close();
+
+    m_file.setFileName(path);
+
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_offset = 0;
+
+    // Falling back to reading, if file can't be mapped
+    m_map = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+
+    m_decoder.reset(QTextCodec::codecForName("UTF-8")->makeDecoder());
+    m_carriageReturn.clear();
+
+    return true;
+}
+
+qint64 QFileLoader::size() const
+{
+    return m_size;
+}
+
+void QFileLoader::start(QTextDocument* document)
+{
+    if (m_loading ||
+        document == nullptr ||
+        !m_file.isOpen())
+    {
+        return;
+    }
+
+    m_document = document;
+    m_loading = true;
+
+    // Text, that's set or typed while loading, would
+    // be mixed with file content
+    m_documentConnection = connect(
+        document,
+        &QTextDocument::contentsChange,
+        this,
+        [this]()
+        {
+            if (!m_appending)
+            {
+                cancel();
+            }
+        }
+    );
+
+    // First chunk is loaded without waiting
+    // for event loop
+    append(readChunk(firstChunkSize));
+
+    emit progress(m_offset, m_size);
+
+    scheduleChunks();
+}
+
+void QFileLoader::cancel()
+{
+    if (m_loading)
+    {
+        stop(false);
+    }
+}
+
+bool QFileLoader::isLoading() const
+{
+    return m_loading;
+}
+
+void QFileLoader::scheduleChunks()
+{
+    if (m_chunksScheduled)
+    {
+        return;
+    }
+
+    m_chunksScheduled = true;
+    QTimer::singleShot(0, this, &QFileLoader::loadChunks);
+}
+
+void QFileLoader::loadChunks()
+{
+    m_chunksScheduled = false;
+
+    if (!m_loading)
+    {
+        return;
+    }
+
+    if (m_document == nullptr)
+    {
+        stop(false);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (m_loading &&
+           m_offset < m_size &&
+           timer.elapsed() < sliceMilliseconds)
+    {
+        append(readChunk(chunkSize));
+    }
+
+    if (!m_loading)
+    {
+        return;
+    }
+
+    emit progress(m_offset, m_size);
+
+    if (m_offset < m_size)
+    {
+        scheduleChunks();
+        return;
+    }
+
+    // Carriage return at file end
+    if (!m_carriageReturn.isEmpty())
+    {
+        append(m_carriageReturn);
+    }
+
+    stop(true);
+}
+
+QString QFileLoader::readChunk(qint64 size)
+{
+    size = qMin(size, m_size - m_offset);
+
+    QString text;
+
+    if (m_map)
+    {
+        text = m_decoder->toUnicode(
+            reinterpret_cast<const char*>(m_map + m_offset),
+            static_cast<int>(size)
+        );
+    }
+    else
+    {
+        auto data = m_file.read(size);
+        size = data.size();
+
+        // File was truncated while reading
+        if (size == 0)
+        {
+            m_size = m_offset;
+        }
+
+        text = m_decoder->toUnicode(data);
+    }
+
+    m_offset += size;
+
+    // Line ending, split between chunks, must
+    // not produce two blocks
+    text.prepend(m_carriageReturn);
+    m_carriageReturn.clear();
+
+    if (text.endsWith('\r'))
+    {
+        text.chop(1);
+        m_carriageReturn = "\r";
+    }
+
+    return text;
+}
+
+void QFileLoader::append(const QString& text)
+{
+    auto cursor = QTextCursor(m_document);
+    cursor.movePosition(QTextCursor::End);
+
+    m_appending = true;
+    cursor.insertText(text);
+    m_appending = false;
+}
+
+void QFileLoader::close()
+{
+    if (m_map)
+    {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    m_file.close();
+    m_decoder.reset();
+    m_carriageReturn.clear();
+}
+
+void QFileLoader::stop(bool completed)
+{
+    close();
+
+    disconnect(m_documentConnection);
+    m_document = nullptr;
+    m_loading = false;
+
+    emit finished(completed);
+}
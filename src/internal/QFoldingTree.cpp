@@ -0,0 +1,1004 @@
+// QCodeEditor
+#include <QFoldingTree>
+#include <QBracketIndex>
+
+// Qt
+#include <QHash>
+#include <QTextBlock>
+#include <QTextDocument>
+
+// std
+#include <limits>
+
+// Blocks after changed ones are compared with previous
+// scan one by one at first, and then with this interval.
+static const int convergenceInterval = 64;
+
+// Width of tab in indentation.
+static const int tabWidth = 4;
+
+// Block, at which unclosed brackets are closed.
+// Shifts don't change it.
+static const int unclosed = std::numeric_limits<int>::max() / 2;
+
+static qint64 regionKey(int start, QFoldingTree::Kind kind)
+{
+    return (static_cast<qint64>(start) << 2) | static_cast<qint64>(kind);
+}
+
+static int shifted(int block, int shift)
+{
+    return block < 0 || block >= unclosed ? block : block + shift;
+}
+
+int QFoldingTree::Mapping::operator()(int block) const
+{
+    if (block < firstChanged)
+    {
+        return block;
+    }
+
+    if (block > lastChangedOld)
+    {
+        return block + delta;
+    }
+
+    return changedBlock;
+}
+
+QFoldingTree::QFoldingTree() :
+    m_indentationBased(false),
+    m_nodes(),
+    m_freeNodes(),
+    m_root(-1),
+    m_seed(2463534242u),
+    m_foldedCount(0),
+    m_blockCount(0),
+    m_dirty(false),
+    m_dirtyFirst(0),
+    m_dirtyLast(-1),
+    m_dirtyBlockCount(0)
+{
+
+}
+
+void QFoldingTree::setIndentationBased(bool enabled)
+{
+    if (m_indentationBased == enabled)
+    {
+        return;
+    }
+
+    m_indentationBased = enabled;
+    invalidateAll();
+}
+
+bool QFoldingTree::isIndentationBased() const
+{
+    return m_indentationBased;
+}
+
+void QFoldingTree::invalidate(int firstBlock, int lastBlock, int blockCount)
+{
+    if (!m_dirty)
+    {
+        m_dirty = true;
+        m_dirtyFirst = firstBlock;
+        m_dirtyLast = lastBlock;
+        m_dirtyBlockCount = blockCount;
+        return;
+    }
+
+    // Blocks, that were changed before, are
+    // shifted by added or removed blocks
+    if (m_dirtyLast >= firstBlock)
+    {
+        m_dirtyLast += blockCount - m_dirtyBlockCount;
+    }
+
+    m_dirtyFirst = qMin(m_dirtyFirst, firstBlock);
+    m_dirtyLast = qMax(m_dirtyLast, lastBlock);
+    m_dirtyBlockCount = blockCount;
+}
+
+void QFoldingTree::invalidateAll()
+{
+    invalidate(0, std::numeric_limits<int>::max() / 2, m_blockCount);
+}
+
+bool QFoldingTree::isDirty() const
+{
+    return m_dirty;
+}
+
+QPair<int, int> QFoldingTree::update(QTextDocument* document)
+{
+    if (!m_dirty ||
+        document == nullptr)
+    {
+        return {0, -1};
+    }
+
+    m_dirty = false;
+
+    auto blockCount = document->blockCount();
+    auto delta = blockCount - m_blockCount;
+    auto firstDirty = qMin(m_dirtyFirst, blockCount - 1);
+    auto lastDirty = qBound(firstDirty, m_dirtyLast, blockCount - 1);
+
+    Mapping mapping = {firstDirty, lastDirty - delta, delta};
+
+    // Scanner continues with entries, that are open
+    // at first changed block
+    auto state = stateAt(firstDirty);
+
+    QVector<Entry> scanned;
+
+    auto number = firstDirty;
+    auto converged = false;
+
+    for (auto block = document->findBlockByNumber(firstDirty);
+         block.isValid();
+         block = block.next(), ++number)
+    {
+        // Rest of document is the same, if state after
+        // changed blocks is the same as before edit
+        auto distance = number - lastDirty;
+
+        if (distance > 0 &&
+            (distance <= convergenceInterval || distance % convergenceInterval == 0) &&
+            isEqual(state, mapState(stateAt(number - delta), mapping)))
+        {
+            converged = true;
+            break;
+        }
+
+        scanBlock(state, block, number, scanned);
+    }
+
+    if (!converged)
+    {
+        finish(state, blockCount, scanned);
+    }
+
+    // Entries, that are closed at scanned blocks of previous
+    // scan, are replaced with scanned ones. Entries, that are
+    // closed later, are kept, only their blocks are shifted.
+    auto convergedOld = converged ?
+        number - delta :
+        std::numeric_limits<int>::max();
+
+    int left = -1;
+    int middle = -1;
+    int right = -1;
+
+    split(m_root, firstDirty, left, middle);
+    split(middle, convergedOld, middle, right);
+
+    QVector<Entry> previous;
+    left = extractOpen(left, firstDirty, previous);
+    extractAll(middle, previous);
+    applyShift(right, delta);
+
+    m_root = merge(left, right);
+
+    auto changedFirst = firstDirty;
+    auto changedLast = converged ? number - 1 : blockCount - 1;
+
+    auto extendChanged = [&changedFirst, &changedLast](int first, int last)
+    {
+        changedFirst = qMin(changedFirst, first);
+        changedLast = qMax(changedLast, last);
+    };
+
+    // Folded regions, that are found again, stay folded
+    QHash<qint64, QPair<int, int>> folded;
+
+    for (auto entry : previous)
+    {
+        if (entry.closed >= convergedOld)
+        {
+            entry.start = mapping(entry.start);
+            entry.end = mapping(entry.end);
+            entry.closed = shifted(entry.closed, delta);
+
+            insertEntry(entry);
+            continue;
+        }
+
+        if (entry.folded)
+        {
+            auto start = mapping(entry.start);
+            auto end = mapping(entry.end);
+
+            // Blocks, hidden by region, may become visible
+            QPair<int, int> hidden = {
+                start < 0 ? firstDirty : start + 1,
+                end < 0 ? lastDirty : end
+            };
+
+            // Region, that started at changed block,
+            // can't be found again
+            if (start < 0)
+            {
+                extendChanged(hidden.first, hidden.second);
+                continue;
+            }
+
+            folded.insert(regionKey(start, entry.kind), hidden);
+        }
+    }
+
+    for (auto entry : scanned)
+    {
+        auto key = regionKey(entry.start, entry.kind);
+        auto found = folded.find(key);
+
+        if (found != folded.end() &&
+            isFoldable(entry))
+        {
+            entry.folded = true;
+
+            if (found->second != entry.end)
+            {
+                extendChanged(found->first, qMax(found->second, entry.end));
+            }
+
+            folded.erase(found);
+        }
+
+        insertEntry(entry);
+    }
+
+    for (auto&& range : folded)
+    {
+        extendChanged(range.first, range.second);
+    }
+
+    m_blockCount = blockCount;
+
+    return {qMax(0, changedFirst), qMin(changedLast, blockCount - 1)};
+}
+
+QFoldingTree::Region QFoldingTree::regionAt(int blockNumber) const
+{
+    QVector<Entry> entries;
+    collectStarting(m_root, 0, blockNumber, entries);
+
+    Region region = {-1, -1, Kind::Braces, false};
+
+    for (auto&& entry : entries)
+    {
+        // Regions with the same blocks are
+        // ordered by kind
+        if (isFoldable(entry) &&
+            (entry.end > region.end ||
+             (entry.end == region.end && entry.kind < region.kind)))
+        {
+            region = {entry.start, entry.end, entry.kind, entry.folded};
+        }
+    }
+
+    return region;
+}
+
+bool QFoldingTree::setFolded(int blockNumber, bool folded)
+{
+    auto region = regionAt(blockNumber);
+
+    if (region.start < 0)
+    {
+        return false;
+    }
+
+    return setFoldedAt(m_root, region, folded);
+}
+
+void QFoldingTree::setAllFolded(bool folded)
+{
+    m_foldedCount = 0;
+    setFoldedAll(m_root, folded);
+}
+
+QPair<int, int> QFoldingTree::unfoldEnclosing(int blockNumber)
+{
+    QPair<int, int> range = {0, -1};
+
+    if (m_foldedCount > 0)
+    {
+        unfoldAt(m_root, blockNumber, range);
+    }
+
+    return range;
+}
+
+bool QFoldingTree::hasFoldedRegions() const
+{
+    return m_foldedCount > 0;
+}
+
+int QFoldingTree::visibleBlock(int blockNumber) const
+{
+    if (m_foldedCount == 0)
+    {
+        return blockNumber;
+    }
+
+    QVector<Entry> entries;
+
+    // Block is hidden by region, which first
+    // block may be hidden by another region
+    while (true)
+    {
+        entries.clear();
+        collectFolded(m_root, 0, blockNumber, blockNumber, entries);
+
+        if (entries.isEmpty())
+        {
+            return blockNumber;
+        }
+
+        blockNumber = entries.first().start;
+    }
+}
+
+QVector<QPair<int, int>> QFoldingTree::hiddenRanges(int firstBlock, int lastBlock) const
+{
+    QVector<QPair<int, int>> ranges;
+
+    if (m_foldedCount == 0)
+    {
+        return ranges;
+    }
+
+    QVector<Entry> entries;
+    collectFolded(m_root, 0, firstBlock, lastBlock, entries);
+
+    for (auto&& entry : entries)
+    {
+        if (!ranges.isEmpty() &&
+            entry.start + 1 <= ranges.last().second + 1)
+        {
+            ranges.last().second = qMax(ranges.last().second, entry.end);
+            continue;
+        }
+
+        ranges.append({entry.start + 1, entry.end});
+    }
+
+    return ranges;
+}
+
+void QFoldingTree::clear()
+{
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_root = -1;
+    m_foldedCount = 0;
+    m_blockCount = 0;
+    m_dirty = false;
+}
+
+void QFoldingTree::scanBlock(State& state,
+                             const QTextBlock& block,
+                             int blockNumber,
+                             QVector<Entry>& entries) const
+{
+    auto index = QBracketIndex::forBlock(block);
+
+    // Brackets, that close regions of previous blocks,
+    // go before brackets, that open new regions
+    auto scanBrackets = [&](QChar bracket, QVector<int>& stack, Kind kind)
+    {
+        auto closed = -index.minDepth(bracket);
+
+        for (int i = 0; i < closed && !stack.isEmpty(); ++i)
+        {
+            addEntry(entries, stack.takeLast(), blockNumber, blockNumber, 0, kind);
+        }
+
+        auto opened = index.delta(bracket) + closed;
+
+        for (int i = 0; i < opened; ++i)
+        {
+            stack.append(blockNumber);
+        }
+    };
+
+    scanBrackets('{', state.braces, Kind::Braces);
+    scanBrackets('[', state.brackets, Kind::Brackets);
+
+    // Multiline comments and strings keep
+    // non zero highlighter state
+    auto blockState = block.userState();
+
+    if (blockState > 0 && state.stateStart < 0)
+    {
+        state.stateStart = blockNumber;
+    }
+    else if (blockState <= 0 && state.stateStart >= 0)
+    {
+        addEntry(entries, state.stateStart, blockNumber, blockNumber, 0, Kind::State);
+        state.stateStart = -1;
+    }
+
+    if (!m_indentationBased)
+    {
+        return;
+    }
+
+    auto text = block.text();
+    auto width = 0;
+    auto blank = true;
+
+    for (auto c : text)
+    {
+        if (c == ' ')
+        {
+            ++width;
+        }
+        else if (c == '\t')
+        {
+            width += tabWidth - width % tabWidth;
+        }
+        else
+        {
+            blank = false;
+            break;
+        }
+    }
+
+    // Empty lines don't close indentation levels
+    if (blank)
+    {
+        return;
+    }
+
+    while (!state.indents.isEmpty() &&
+           state.indents.last().width >= width)
+    {
+        auto indent = state.indents.takeLast();
+        addEntry(entries, indent.block, state.lastNonBlank, blockNumber, indent.width, Kind::Indentation);
+    }
+
+    state.indents.append({width, blockNumber});
+    state.lastNonBlank = blockNumber;
+}
+
+void QFoldingTree::finish(State& state,
+                          int blockCount,
+                          QVector<Entry>& entries) const
+{
+    // Unclosed brackets don't make regions, but
+    // they are a part of scanner state
+    for (auto start : state.braces)
+    {
+        addEntry(entries, start, start, unclosed, 0, Kind::Braces);
+    }
+
+    for (auto start : state.brackets)
+    {
+        addEntry(entries, start, start, unclosed, 0, Kind::Brackets);
+    }
+
+    if (state.stateStart >= 0)
+    {
+        addEntry(entries, state.stateStart, blockCount - 1, blockCount, 0, Kind::State);
+    }
+
+    for (auto&& indent : state.indents)
+    {
+        addEntry(entries, indent.block, state.lastNonBlank, blockCount, indent.width, Kind::Indentation);
+    }
+}
+
+QFoldingTree::State QFoldingTree::stateAt(int blockNumber) const
+{
+    QVector<Entry> entries;
+    collectOpen(m_root, 0, blockNumber, entries);
+
+    auto state = emptyState();
+
+    // Entries are sorted by first block, as
+    // scanner has pushed them
+    for (auto&& entry : entries)
+    {
+        switch (entry.kind)
+        {
+        case Kind::Braces:
+            state.braces.append(entry.start);
+            break;
+
+        case Kind::Brackets:
+            state.brackets.append(entry.start);
+            break;
+
+        case Kind::State:
+            state.stateStart = entry.start;
+            break;
+
+        case Kind::Indentation:
+            state.indents.append({entry.width, entry.start});
+            state.lastNonBlank = entry.start;
+            break;
+        }
+    }
+
+    return state;
+}
+
+void QFoldingTree::addEntry(QVector<Entry>& entries,
+                            int start,
+                            int end,
+                            int closed,
+                            int width,
+                            Kind kind)
+{
+    // Entry, that's closed at its first block,
+    // is never a part of scanner state
+    if (closed > start)
+    {
+        entries.append({start, end, closed, width, kind, false});
+    }
+}
+
+bool QFoldingTree::isFoldable(const Entry& entry)
+{
+    return entry.end > entry.start;
+}
+
+QFoldingTree::State QFoldingTree::emptyState()
+{
+    return {{}, {}, -1, {}, -1};
+}
+
+QFoldingTree::State QFoldingTree::mapState(const State& state, const Mapping& mapping)
+{
+    auto result = state;
+
+    for (auto&& block : result.braces)
+    {
+        block = mapping(block);
+    }
+
+    for (auto&& block : result.brackets)
+    {
+        block = mapping(block);
+    }
+
+    for (auto&& indent : result.indents)
+    {
+        indent.block = mapping(indent.block);
+    }
+
+    result.stateStart = mapping(result.stateStart);
+    result.lastNonBlank = mapping(result.lastNonBlank);
+
+    return result;
+}
+
+bool QFoldingTree::isEqual(const State& a, const State& b)
+{
+    if (a.braces != b.braces ||
+        a.brackets != b.brackets ||
+        a.stateStart != b.stateStart ||
+        a.lastNonBlank != b.lastNonBlank ||
+        a.indents.size() != b.indents.size())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < a.indents.size(); ++i)
+    {
+        if (a.indents[i].width != b.indents[i].width ||
+            a.indents[i].block != b.indents[i].block)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int QFoldingTree::createNode(const Entry& entry)
+{
+    // Xorshift is enough for treap priorities
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node node = {entry, m_seed, -1, -1, 0, 0, 0};
+
+    int index;
+
+    if (m_freeNodes.isEmpty())
+    {
+        index = m_nodes.size();
+        m_nodes.append(node);
+    }
+    else
+    {
+        index = m_freeNodes.takeLast();
+        m_nodes[index] = node;
+    }
+
+    pull(index);
+
+    if (entry.folded)
+    {
+        ++m_foldedCount;
+    }
+
+    return index;
+}
+
+void QFoldingTree::releaseNode(int node)
+{
+    if (m_nodes[node].entry.folded)
+    {
+        --m_foldedCount;
+    }
+
+    m_freeNodes.append(node);
+}
+
+void QFoldingTree::insertEntry(const Entry& entry)
+{
+    auto node = createNode(entry);
+
+    int left = -1;
+    int right = -1;
+    split(m_root, entry.start, left, right);
+
+    m_root = merge(merge(left, node), right);
+}
+
+void QFoldingTree::applyShift(int node, int shift)
+{
+    if (node < 0 || shift == 0)
+    {
+        return;
+    }
+
+    auto& n = m_nodes[node];
+
+    n.entry.start += shift;
+    n.entry.end += shift;
+    n.entry.closed = shifted(n.entry.closed, shift);
+    n.maxClosed = shifted(n.maxClosed, shift);
+    n.maxFoldedEnd = shifted(n.maxFoldedEnd, shift);
+    n.shift += shift;
+}
+
+void QFoldingTree::push(int node)
+{
+    auto shift = m_nodes[node].shift;
+
+    if (shift == 0)
+    {
+        return;
+    }
+
+    applyShift(m_nodes[node].left, shift);
+    applyShift(m_nodes[node].right, shift);
+    m_nodes[node].shift = 0;
+}
+
+void QFoldingTree::pull(int node)
+{
+    auto& n = m_nodes[node];
+
+    n.maxClosed = n.entry.closed;
+    n.maxFoldedEnd = n.entry.folded ? n.entry.end : -1;
+
+    for (auto child : {n.left, n.right})
+    {
+        if (child >= 0)
+        {
+            n.maxClosed = qMax(n.maxClosed, m_nodes[child].maxClosed);
+            n.maxFoldedEnd = qMax(n.maxFoldedEnd, m_nodes[child].maxFoldedEnd);
+        }
+    }
+}
+
+void QFoldingTree::split(int node, int start, int& left, int& right)
+{
+    if (node < 0)
+    {
+        left = -1;
+        right = -1;
+        return;
+    }
+
+    push(node);
+
+    int first = -1;
+    int second = -1;
+
+    if (m_nodes[node].entry.start < start)
+    {
+        split(m_nodes[node].right, start, first, second);
+        m_nodes[node].right = first;
+        left = node;
+        right = second;
+    }
+    else
+    {
+        split(m_nodes[node].left, start, first, second);
+        m_nodes[node].left = second;
+        left = first;
+        right = node;
+    }
+
+    pull(node);
+}
+
+int QFoldingTree::merge(int left, int right)
+{
+    if (left < 0)
+    {
+        return right;
+    }
+
+    if (right < 0)
+    {
+        return left;
+    }
+
+    if (m_nodes[left].priority > m_nodes[right].priority)
+    {
+        push(left);
+        auto child = merge(m_nodes[left].right, right);
+        m_nodes[left].right = child;
+        pull(left);
+        return left;
+    }
+
+    push(right);
+    auto child = merge(left, m_nodes[right].left);
+    m_nodes[right].left = child;
+    pull(right);
+    return right;
+}
+
+int QFoldingTree::extractOpen(int node, int blockNumber, QVector<Entry>& entries)
+{
+    if (node < 0 ||
+        m_nodes[node].maxClosed < blockNumber)
+    {
+        return node;
+    }
+
+    push(node);
+
+    auto left = extractOpen(m_nodes[node].left, blockNumber, entries);
+    auto right = extractOpen(m_nodes[node].right, blockNumber, entries);
+
+    m_nodes[node].left = left;
+    m_nodes[node].right = right;
+
+    if (m_nodes[node].entry.closed >= blockNumber)
+    {
+        entries.append(m_nodes[node].entry);
+        releaseNode(node);
+        return merge(left, right);
+    }
+
+    pull(node);
+    return node;
+}
+
+void QFoldingTree::extractAll(int node, QVector<Entry>& entries)
+{
+    if (node < 0)
+    {
+        return;
+    }
+
+    push(node);
+
+    extractAll(m_nodes[node].left, entries);
+    entries.append(m_nodes[node].entry);
+    extractAll(m_nodes[node].right, entries);
+
+    releaseNode(node);
+}
+
+void QFoldingTree::collectOpen(int node,
+                               int offset,
+                               int blockNumber,
+                               QVector<Entry>& entries) const
+{
+    if (node < 0 ||
+        shifted(m_nodes[node].maxClosed, offset) < blockNumber)
+    {
+        return;
+    }
+
+    auto& n = m_nodes[node];
+    auto entry = n.entry;
+    entry.start += offset;
+    entry.end += offset;
+    entry.closed = shifted(entry.closed, offset);
+
+    collectOpen(n.left, offset + n.shift, blockNumber, entries);
+
+    if (entry.start < blockNumber)
+    {
+        if (entry.closed >= blockNumber)
+        {
+            entries.append(entry);
+        }
+
+        collectOpen(n.right, offset + n.shift, blockNumber, entries);
+    }
+}
+
+void QFoldingTree::collectStarting(int node,
+                                   int offset,
+                                   int blockNumber,
+                                   QVector<Entry>& entries) const
+{
+    if (node < 0)
+    {
+        return;
+    }
+
+    auto& n = m_nodes[node];
+    auto entry = n.entry;
+    entry.start += offset;
+    entry.end += offset;
+
+    // Entries with the same first block may be
+    // in both subtrees
+    if (entry.start >= blockNumber)
+    {
+        collectStarting(n.left, offset + n.shift, blockNumber, entries);
+    }
+
+    if (entry.start == blockNumber)
+    {
+        entries.append(entry);
+    }
+
+    if (entry.start <= blockNumber)
+    {
+        collectStarting(n.right, offset + n.shift, blockNumber, entries);
+    }
+}
+
+void QFoldingTree::collectFolded(int node,
+                                 int offset,
+                                 int firstBlock,
+                                 int lastBlock,
+                                 QVector<Entry>& entries) const
+{
+    if (node < 0 ||
+        shifted(m_nodes[node].maxFoldedEnd, offset) < firstBlock)
+    {
+        return;
+    }
+
+    auto& n = m_nodes[node];
+    auto entry = n.entry;
+    entry.start += offset;
+    entry.end += offset;
+
+    collectFolded(n.left, offset + n.shift, firstBlock, lastBlock, entries);
+
+    // Region hides blocks after first one
+    if (entry.start + 1 <= lastBlock)
+    {
+        if (entry.folded &&
+            entry.end >= firstBlock)
+        {
+            entries.append(entry);
+        }
+
+        collectFolded(n.right, offset + n.shift, firstBlock, lastBlock, entries);
+    }
+}
+
+bool QFoldingTree::setFoldedAt(int node, const Region& region, bool folded)
+{
+    if (node < 0)
+    {
+        return false;
+    }
+
+    push(node);
+
+    auto& entry = m_nodes[node].entry;
+    auto found = false;
+
+    if (entry.start > region.start)
+    {
+        found = setFoldedAt(m_nodes[node].left, region, folded);
+    }
+    else if (entry.start < region.start)
+    {
+        found = setFoldedAt(m_nodes[node].right, region, folded);
+    }
+    else if (entry.end == region.end &&
+             entry.kind == region.kind)
+    {
+        if (entry.folded != folded)
+        {
+            entry.folded = folded;
+            m_foldedCount += folded ? 1 : -1;
+        }
+
+        found = true;
+    }
+    else
+    {
+        found = setFoldedAt(m_nodes[node].left, region, folded) ||
+                setFoldedAt(m_nodes[node].right, region, folded);
+    }
+
+    pull(node);
+
+    return found;
+}
+
+void QFoldingTree::setFoldedAll(int node, bool folded)
+{
+    if (node < 0)
+    {
+        return;
+    }
+
+    push(node);
+
+    setFoldedAll(m_nodes[node].left, folded);
+    setFoldedAll(m_nodes[node].right, folded);
+
+    auto& entry = m_nodes[node].entry;
+    entry.folded = folded && isFoldable(entry);
+
+    if (entry.folded)
+    {
+        ++m_foldedCount;
+    }
+
+    pull(node);
+}
+
+void QFoldingTree::unfoldAt(int node, int blockNumber, QPair<int, int>& range)
+{
+    if (node < 0 ||
+        m_nodes[node].maxFoldedEnd < blockNumber)
+    {
+        return;
+    }
+
+    push(node);
+
+    unfoldAt(m_nodes[node].left, blockNumber, range);
+
+    auto& entry = m_nodes[node].entry;
+
+    if (entry.start < blockNumber)
+    {
+        if (entry.folded &&
+            entry.end >= blockNumber)
+        {
+            entry.folded = false;
+            --m_foldedCount;
+
+            if (range.second < range.first)
+            {
+                range = {entry.start + 1, entry.end};
+            }
+            else
+            {
+                range.first = qMin(range.first, entry.start + 1);
+                range.second = qMax(range.second, entry.end);
+            }
+        }
+
+        unfoldAt(m_nodes[node].right, blockNumber, range);
+    }
+
+    pull(node);
+}
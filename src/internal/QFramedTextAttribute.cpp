@@ -7,6 +7,7 @@
 #include <QPainter>
 #include <QDebug>
 #include <QTextBlock>
+#include <QTextDocument>
 
 int QFramedTextAttribute::type()
 {
@@ -15,7 +16,9 @@ int QFramedTextAttribute::type()
 
 QFramedTextAttribute::QFramedTextAttribute(QObject* parent) :
     QObject(parent),
-    m_style(nullptr)
+    m_style(nullptr),
+    m_frames(),
+    m_trackedDocuments()
 {
 
 }
@@ -65,7 +68,9 @@ void QFramedTextAttribute::drawObject(QPainter* painter,
 
 void QFramedTextAttribute::frame(QTextCursor cursor)
 {
-    auto text = cursor.document()->findBlockByNumber(cursor.blockNumber()).text();
+    // Inserted character is added to frames
+    // on contents change
+    trackDocument(cursor.document());
 
     QTextCharFormat format;
     format.setObjectType(type());
@@ -88,25 +93,158 @@ void QFramedTextAttribute::frame(QTextCursor cursor)
 
 void QFramedTextAttribute::clear(QTextCursor cursor)
 {
+    if (m_frames.isEmpty())
+    {
+        return;
+    }
+
     auto doc = cursor.document();
 
-    for (auto blockIndex = 0;
-         blockIndex < doc->blockCount();
-         ++blockIndex)
+    QVector<QTextCursor> frames;
+    frames.swap(m_frames);
+
+    // All frames are removed by one undo step
+    cursor.beginEditBlock();
+
+    for (auto& frame : frames)
+    {
+        // Frames of deleted documents are dropped,
+        // frames of other documents are kept
+        if (frame.isNull())
+        {
+            continue;
+        }
+
+        if (frame.document() != doc)
+        {
+            m_frames.append(frame);
+            continue;
+        }
+
+        // Frame character may be already removed by
+        // user, duplicate cursor is empty after first
+        // one removed the character
+        if (frame.hasSelection() &&
+            frame.charFormat().objectType() == type())
+        {
+            frame.removeSelectedText();
+        }
+    }
+
+    cursor.endEditBlock();
+}
+
+void QFramedTextAttribute::trackDocument(QTextDocument* document)
+{
+    if (m_trackedDocuments.contains(document))
     {
-        auto block = doc->findBlockByNumber(blockIndex);
+        return;
+    }
+
+    m_trackedDocuments.insert(document);
 
-        auto formats = block.textFormats();
-        int offset = 0;
+    connect(
+        document,
+        &QTextDocument::contentsChange,
+        this,
+        [this, document](int position, int charsRemoved, int charsAdded)
+        {
+            if (charsAdded > 0)
+            {
+                addFrames(document, position, charsRemoved, charsAdded);
+            }
+        }
+    );
+
+    connect(
+        document,
+        &QObject::destroyed,
+        this,
+        [this, document]()
+        {
+            m_trackedDocuments.remove(document);
+        }
+    );
+}
 
-        for (auto& format : formats)
+void QFramedTextAttribute::addFrames(QTextDocument* document,
+                                     int position,
+                                     int charsRemoved,
+                                     int charsAdded)
+{
+    auto end = position + charsAdded;
+
+    // Inserted characters can't be framed yet. Format
+    // change reports kept characters as removed and
+    // added, so frames of them are collected once.
+    QSet<int> framed;
+    auto framedCollected = charsRemoved == 0;
+
+    // Fragments keep formats without copying text,
+    // frame characters have object format
+    for (auto block = document->findBlock(position);
+         block.isValid() && block.position() < end;
+         block = block.next())
+    {
+        for (auto it = block.begin(); !it.atEnd(); ++it)
         {
-            if (format.format.objectType() == type())
+            auto fragment = it.fragment();
+
+            if (fragment.position() + fragment.length() <= position ||
+                fragment.position() >= end ||
+                fragment.charFormat().objectType() != type())
+            {
+                continue;
+            }
+
+            if (!framedCollected)
             {
-                cursor.setPosition(block.position() + format.start - offset);
-                cursor.deleteChar();
-                ++offset;
+                framed = framedPositions(document, position, end);
+                framedCollected = true;
+            }
+
+            for (auto i = fragment.position(); i < fragment.position() + fragment.length(); ++i)
+            {
+                if (framed.contains(i))
+                {
+                    continue;
+                }
+
+                QTextCursor frame(document);
+                frame.setPosition(i);
+                frame.setPosition(i + 1, QTextCursor::MoveMode::KeepAnchor);
+
+                m_frames.append(frame);
             }
         }
     }
 }
+
+QSet<int> QFramedTextAttribute::framedPositions(QTextDocument* document, int first, int last)
+{
+    QSet<int> positions;
+    QVector<QTextCursor> frames;
+
+    // Cursors of removed characters are dropped
+    for (auto& frame : m_frames)
+    {
+        if (frame.isNull() ||
+            !frame.hasSelection())
+        {
+            continue;
+        }
+
+        frames.append(frame);
+
+        if (frame.document() == document &&
+            frame.selectionStart() >= first &&
+            frame.selectionStart() < last)
+        {
+            positions.insert(frame.selectionStart());
+        }
+    }
+
+    m_frames.swap(frames);
+
+    return positions;
+}
@@ -0,0 +1,221 @@
+// QCodeEditor
+#include <QHighlightBlockData>
+
+// Qt
+#include <QTextBlock>
+#include <QVarLengthArray>
+
+// std
+#include <algorithm>
+
+QHighlightBlockData::QHighlightBlockData() :
+    QTextBlockUserData(),
+    m_status(Status::Highlighted),
+    m_highlightRevision(0),
+    m_formatted(true),
+    m_bracketIndex(),
+    m_hasBracketIndex(false),
+    m_tokenArena(),
+    m_tokens(nullptr),
+    m_tokenCount(0),
+    m_tokenCapacity(0),
+    m_tokensComplete(false)
+{
+
+}
+
+QHighlightBlockData::~QHighlightBlockData()
+{
+    if (m_tokenArena)
+    {
+        m_tokenArena->release(m_tokens, m_tokenCapacity);
+    }
+}
+
+QHighlightBlockData* QHighlightBlockData::get(const QTextBlock& block)
+{
+    return dynamic_cast<QHighlightBlockData*>(block.userData());
+}
+
+void QHighlightBlockData::setStatus(Status status)
+{
+    m_status = status;
+}
+
+QHighlightBlockData::Status QHighlightBlockData::status() const
+{
+    return m_status;
+}
+
+bool QHighlightBlockData::isPending() const
+{
+    return m_status != Status::Highlighted;
+}
+
+void QHighlightBlockData::setFormatted(bool formatted)
+{
+    m_formatted = formatted;
+}
+
+bool QHighlightBlockData::isFormatted() const
+{
+    return m_formatted;
+}
+
+void QHighlightBlockData::setHighlightRevision(int revision)
+{
+    m_highlightRevision = revision;
+}
+
+int QHighlightBlockData::highlightRevision() const
+{
+    return m_highlightRevision;
+}
+
+void QHighlightBlockData::setBracketIndex(QBracketIndex index)
+{
+    m_bracketIndex = std::move(index);
+    m_hasBracketIndex = true;
+}
+
+const QBracketIndex& QHighlightBlockData::bracketIndex() const
+{
+    return m_bracketIndex;
+}
+
+bool QHighlightBlockData::hasBracketIndex() const
+{
+    return m_hasBracketIndex;
+}
+
+
+void QHighlightBlockData::setTokens(const QSharedPointer<QTokenArena>& arena,
+                                    const QVector<QHighlightContext::Range>& ranges,
+                                    int length)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    // Painting format ids over characters
+    QVarLengthArray<int, 512> formatIds(length);
+    std::fill(formatIds.begin(), formatIds.end(), -1);
+
+    for (auto&& range : ranges)
+    {
+        auto start = qBound(0, range.start, length);
+        auto end = qBound(start, range.start + range.length, length);
+
+        std::fill(formatIds.begin() + start, formatIds.begin() + end, range.formatId);
+    }
+
+    QVarLengthArray<QTokenArena::Token, 64> tokens;
+    auto complete = true;
+
+    for (int start = 0; start < length;)
+    {
+        auto formatId = formatIds[start];
+        auto end = start + 1;
+
+        while (end < length &&
+               formatIds[end] == formatId &&
+               end - start < QTokenArena::Token::maxLength)
+        {
+            ++end;
+        }
+
+        if (formatId >= 0 &&
+            formatId <= QTokenArena::Token::maxFormatId)
+        {
+            if (tokens.size() == maxTokens)
+            {
+                complete = false;
+                break;
+            }
+
+            tokens.append(QTokenArena::Token::make(start, end - start, formatId));
+        }
+
+        start = end;
+    }
+
+    // Array is reused, if it's big enough
+    if (m_tokenArena != arena ||
+        m_tokenCapacity < tokens.size())
+    {
+        if (m_tokenArena)
+        {
+            m_tokenArena->release(m_tokens, m_tokenCapacity);
+        }
+
+        m_tokenArena = arena;
+        m_tokens = nullptr;
+        m_tokenCapacity = 0;
+
+        if (!tokens.isEmpty())
+        {
+            m_tokens = m_tokenArena->allocate(tokens.size(), m_tokenCapacity);
+        }
+    }
+
+    std::copy(tokens.begin(), tokens.end(), m_tokens);
+    m_tokenCount = tokens.size();
+    m_tokensComplete = complete;
+}
+
+bool QHighlightBlockData::hasTokens() const
+{
+    return !m_tokenArena.isNull();
+}
+
+bool QHighlightBlockData::isTokensComplete() const
+{
+    return m_tokensComplete;
+}
+
+int QHighlightBlockData::tokenCount() const
+{
+    return m_tokenCount;
+}
+
+const QTokenArena::Token& QHighlightBlockData::token(int index) const
+{
+    return m_tokens[index];
+}
+
+int QHighlightBlockData::tokenAt(int position) const
+{
+    auto end = m_tokens + m_tokenCount;
+
+    // First token, that ends after position
+    auto found = std::upper_bound(
+        m_tokens,
+        end,
+        position,
+        [](int value, const QTokenArena::Token& token)
+        { return value < token.end(); }
+    );
+
+    if (found == end ||
+        found->start() > position)
+    {
+        return -1;
+    }
+
+    return static_cast<int>(found - m_tokens);
+}
+
+int QHighlightBlockData::formatIdAt(const QTextBlock& block, int position)
+{
+    auto data = get(block);
+
+    if (data == nullptr)
+    {
+        return -1;
+    }
+
+    auto index = data->tokenAt(position);
+
+    return index < 0 ? -1 : data->token(index).formatId();
+}
@@ -0,0 +1,96 @@
+// QCodeEditor
+#include <QHighlightContext>
+
+// Qt
+#include <QRegularExpression>
+
+QHighlightContext::QHighlightContext(int previousBlockState) :
+    m_previousBlockState(previousBlockState),
+    m_currentBlockState(-1),
+    m_formats(),
+    m_instrumented(false),
+    m_ruleName(),
+    m_ruleTimer(),
+    m_ruleRuns()
+{
+
+}
+
+int QHighlightContext::previousBlockState() const
+{
+    return m_previousBlockState;
+}
+
+int QHighlightContext::currentBlockState() const
+{
+    return m_currentBlockState;
+}
+
+void QHighlightContext::setCurrentBlockState(int state)
+{
+    m_currentBlockState = state;
+}
+
+void QHighlightContext::setFormat(int start, int count, int formatId)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    m_formats.append({start, count, formatId});
+}
+
+const QVector<QHighlightContext::Range>& QHighlightContext::formats() const
+{
+    return m_formats;
+}
+
+void QHighlightContext::setInstrumented(bool enabled)
+{
+    m_instrumented = enabled;
+}
+
+bool QHighlightContext::isInstrumented() const
+{
+    return m_instrumented;
+}
+
+void QHighlightContext::beginRule(const QRegularExpression& pattern)
+{
+    if (!m_instrumented)
+    {
+        return;
+    }
+
+    m_ruleName = pattern.pattern();
+    m_ruleTimer.start();
+}
+
+void QHighlightContext::beginEndRule(const QRegularExpression& pattern)
+{
+    if (!m_instrumented)
+    {
+        return;
+    }
+
+    m_ruleName = QStringLiteral("end: ") + pattern.pattern();
+    m_ruleTimer.start();
+}
+
+void QHighlightContext::endRule(int matches)
+{
+    if (!m_instrumented ||
+        !m_ruleTimer.isValid())
+    {
+        return;
+    }
+
+    m_ruleRuns.append({m_ruleName, m_ruleTimer.nsecsElapsed(), matches});
+    m_ruleTimer.invalidate();
+}
+
+const QVector<QHighlightContext::RuleRun>& QHighlightContext::ruleRuns() const
+{
+    return m_ruleRuns;
+}
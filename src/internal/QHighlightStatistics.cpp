@@ -0,0 +1,120 @@
+// QCodeEditor
+#include <QHighlightStatistics>
+#include <QHighlightContext>
+
+// Qt
+#include <QJsonArray>
+
+// std
+#include <algorithm>
+
+static double milliseconds(qint64 nanoseconds)
+{
+    return nanoseconds / 1e6;
+}
+
+QHighlightStatistics::QHighlightStatistics() :
+    blocks(0),
+    nanoseconds(0),
+    cascades(0),
+    rules(),
+    slowestBlocks()
+{
+
+}
+
+void QHighlightStatistics::addBlock(int blockNumber,
+                                   int length,
+                                   qint64 blockNanoseconds,
+                                   const QHighlightContext& context,
+                                   bool cascade)
+{
+    ++blocks;
+    nanoseconds += blockNanoseconds;
+
+    if (cascade)
+    {
+        ++cascades;
+    }
+
+    for (auto&& run : context.ruleRuns())
+    {
+        auto rule = rules.find(run.name);
+
+        if (rule == rules.end())
+        {
+            rule = rules.insert(run.name, {run.name, 0, 0, 0});
+        }
+
+        ++rule->calls;
+        rule->matches += run.matches;
+        rule->nanoseconds += run.nanoseconds;
+    }
+
+    if (slowestBlocks.size() == slowestBlocksCount &&
+        slowestBlocks.last().nanoseconds >= blockNanoseconds)
+    {
+        return;
+    }
+
+    auto position = std::upper_bound(
+        slowestBlocks.begin(),
+        slowestBlocks.end(),
+        blockNanoseconds,
+        [](qint64 value, const Block& block)
+        { return value > block.nanoseconds; }
+    );
+
+    slowestBlocks.insert(position, {blockNumber, length, blockNanoseconds});
+
+    if (slowestBlocks.size() > slowestBlocksCount)
+    {
+        slowestBlocks.removeLast();
+    }
+}
+
+QJsonObject QHighlightStatistics::toJson() const
+{
+    auto sortedRules = rules.values();
+
+    std::sort(
+        sortedRules.begin(),
+        sortedRules.end(),
+        [](const Rule& a, const Rule& b)
+        { return a.nanoseconds > b.nanoseconds; }
+    );
+
+    QJsonArray rulesArray;
+
+    for (auto&& rule : sortedRules)
+    {
+        QJsonObject entry;
+        entry["name"] = rule.name;
+        entry["calls"] = rule.calls;
+        entry["matches"] = rule.matches;
+        entry["milliseconds"] = milliseconds(rule.nanoseconds);
+
+        rulesArray.append(entry);
+    }
+
+    QJsonArray blocksArray;
+
+    for (auto&& block : slowestBlocks)
+    {
+        QJsonObject entry;
+        entry["block"] = block.blockNumber;
+        entry["length"] = block.length;
+        entry["milliseconds"] = milliseconds(block.nanoseconds);
+
+        blocksArray.append(entry);
+    }
+
+    QJsonObject result;
+    result["blocks"] = blocks;
+    result["milliseconds"] = milliseconds(nanoseconds);
+    result["cascades"] = cascades;
+    result["rules"] = rulesArray;
+    result["slowestBlocks"] = blocksArray;
+
+    return result;
+}
@@ -0,0 +1,163 @@
+// QCodeEditor
+#include <QIdentifierCompleter>
+#include <QIdentifierIndex>
+
+// Qt
+#include <QStringListModel>
+
+// std
+#include <algorithm>
+
+// Larger changes, like opening of document,
+// are merged by resetting model
+static const int maxRowChanges = 64;
+
+/**
+ * @brief Static function for comparing words in
+ * the same order as case insensitively sorted
+ * model of completer.
+ */
+static bool wordLessThan(const QString& first, const QString& second)
+{
+    auto result = QString::compare(first, second, Qt::CaseInsensitive);
+
+    return result != 0 ? result < 0 : first < second;
+}
+
+QIdentifierCompleter::QIdentifierCompleter(QObject* parent) :
+    QCompleter(parent),
+    m_model(new QStringListModel(this)),
+    m_index(new QIdentifierIndex(this)),
+    m_keywords(),
+    m_words()
+{
+    setModel(m_model);
+    setCompletionColumn(0);
+    setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    setCaseSensitivity(Qt::CaseSensitive);
+    setWrapAround(true);
+
+    connect(
+        m_index,
+        &QIdentifierIndex::identifiersChanged,
+        this,
+        &QIdentifierCompleter::mergeIdentifiers
+    );
+}
+
+void QIdentifierCompleter::setKeywords(const QStringList& keywords)
+{
+    QStringList words;
+
+    // Keeping identifiers of document
+    for (auto&& word : m_words)
+    {
+        if (!m_keywords.contains(word))
+        {
+            words.append(word);
+        }
+    }
+
+    // Range constructor of QSet requires Qt 5.14
+    m_keywords.clear();
+    for (auto&& keyword : keywords)
+    {
+        m_keywords.insert(keyword);
+    }
+
+    words.append(keywords);
+    std::sort(words.begin(), words.end(), wordLessThan);
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    m_words = words;
+    m_model->setStringList(m_words);
+}
+
+void QIdentifierCompleter::setDocument(QTextDocument* document)
+{
+    if (m_index->document() == document)
+    {
+        return;
+    }
+
+    // Dropping identifiers of previous document
+    m_words = m_keywords.values();
+    std::sort(m_words.begin(), m_words.end(), wordLessThan);
+    m_model->setStringList(m_words);
+
+    m_index->setDocument(document);
+}
+
+QTextDocument* QIdentifierCompleter::document() const
+{
+    return m_index->document();
+}
+
+void QIdentifierCompleter::mergeIdentifiers(const QStringList& added, const QStringList& removed)
+{
+    if (added.size() + removed.size() > maxRowChanges)
+    {
+        QSet<QString> removedSet;
+        for (auto&& word : removed)
+        {
+            removedSet.insert(word);
+        }
+
+        QStringList words;
+
+        for (auto&& word : m_words)
+        {
+            if (m_keywords.contains(word) ||
+                !removedSet.contains(word))
+            {
+                words.append(word);
+            }
+        }
+
+        words.append(added);
+        std::sort(words.begin(), words.end(), wordLessThan);
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        m_words = words;
+        m_model->setStringList(m_words);
+        return;
+    }
+
+    for (auto&& word : removed)
+    {
+        auto position = lowerBound(word);
+
+        if (m_keywords.contains(word) ||
+            position >= m_words.size() ||
+            m_words[position] != word)
+        {
+            continue;
+        }
+
+        m_words.removeAt(position);
+        m_model->removeRows(position, 1);
+    }
+
+    for (auto&& word : added)
+    {
+        auto position = lowerBound(word);
+
+        // Keyword is already in model
+        if (position < m_words.size() &&
+            m_words[position] == word)
+        {
+            continue;
+        }
+
+        m_words.insert(position, word);
+        m_model->insertRows(position, 1);
+        m_model->setData(m_model->index(position), word);
+    }
+}
+
+int QIdentifierCompleter::lowerBound(const QString& word) const
+{
+    return static_cast<int>(
+        std::lower_bound(m_words.begin(), m_words.end(), word, wordLessThan) - m_words.begin()
+    );
+}
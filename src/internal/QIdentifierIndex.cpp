@@ -0,0 +1,333 @@
+// QCodeEditor
+#include <QIdentifierIndex>
+
+// Qt
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTimer>
+
+// Shorter identifiers aren't worth completing
+static const int minimumLength = 3;
+
+// Number of blocks, copied at once, when
+// document is indexed from scratch
+static const int snapshotBlocks = 1024;
+
+/**
+ * @brief Static function for splitting text of
+ * block into different identifiers.
+ */
+static QStringList splitIdentifiers(const QString& text)
+{
+    QStringList identifiers;
+
+    int index = 0;
+    while (index < text.size())
+    {
+        auto character = text[index];
+
+        if (!character.isLetter() && character != '_')
+        {
+            ++index;
+            continue;
+        }
+
+        auto start = index;
+        while (index < text.size() &&
+               (text[index].isLetterOrNumber() || text[index] == '_'))
+        {
+            ++index;
+        }
+
+        if (index - start >= minimumLength)
+        {
+            identifiers.append(text.mid(start, index - start));
+        }
+    }
+
+    identifiers.removeDuplicates();
+
+    return identifiers;
+}
+
+/**
+ * @brief Class, that describes background job.
+ * It applies queued updates, until queue is empty.
+ */
+class QIdentifierIndex::Job : public QRunnable
+{
+public:
+
+    explicit Job(QIdentifierIndex* index) :
+        QRunnable(),
+        m_index(index)
+    {}
+
+    // Disable copying
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    void run() override
+    {
+        while (true)
+        {
+            QVector<Update> updates;
+
+            {
+                QMutexLocker locker(&m_index->m_mutex);
+
+                if (m_index->m_updates.isEmpty())
+                {
+                    m_index->m_jobRunning = false;
+                    return;
+                }
+
+                updates.swap(m_index->m_updates);
+            }
+
+            auto generation = m_index->m_generation.loadAcquire();
+
+            QHash<QString, int> changes;
+
+            for (auto&& update : updates)
+            {
+                // Updates of previous document are dropped,
+                // new document starts with replacing all blocks
+                if (update.generation == generation)
+                {
+                    m_index->applyUpdate(update, changes);
+                }
+            }
+
+            m_index->reportChanges(generation, changes);
+        }
+    }
+
+private:
+
+    QIdentifierIndex* m_index;
+};
+
+QIdentifierIndex::QIdentifierIndex(QObject* parent) :
+    QObject(parent),
+    m_document(),
+    m_blockCount(0),
+    m_indexedBlocks(0),
+    m_snapshotScheduled(false),
+    m_threadPool(),
+    m_generation(0),
+    m_mutex(),
+    m_updates(),
+    m_jobRunning(false),
+    m_trie(),
+    m_blockIdentifiers()
+{
+    m_threadPool.setMaxThreadCount(1);
+}
+
+QIdentifierIndex::~QIdentifierIndex()
+{
+    m_generation.fetchAndAddOrdered(1);
+    m_threadPool.waitForDone();
+}
+
+void QIdentifierIndex::setDocument(QTextDocument* document)
+{
+    if (m_document)
+    {
+        disconnect(m_document, nullptr, this, nullptr);
+    }
+
+    m_document = document;
+    m_generation.fetchAndAddOrdered(1);
+
+    // Releasing memory of previous document
+    m_blockCount = 0;
+    m_indexedBlocks = 0;
+    enqueue(0, -1, -1);
+
+    if (m_document == nullptr)
+    {
+        return;
+    }
+
+    m_blockCount = m_document->blockCount();
+    scheduleSnapshot();
+
+    connect(
+        m_document,
+        &QTextDocument::contentsChange,
+        this,
+        [this](int position, int, int charsAdded)
+        {
+            auto blockCount = m_document->blockCount();
+            auto last = blockCount - 1;
+            auto first = m_document->findBlock(position).blockNumber();
+            auto end = m_document->findBlock(position + charsAdded).blockNumber();
+
+            first = first < 0 ? last : first;
+            end = end < 0 ? last : end;
+
+            // Changed blocks replace the same blocks,
+            // and inserted or removed blocks
+            auto removed = end - first + 1 - (blockCount - m_blockCount);
+            m_blockCount = blockCount;
+
+            // Blocks, that were not copied yet, are
+            // copied by snapshot with new text
+            if (first >= m_indexedBlocks)
+            {
+                return;
+            }
+
+            auto indexedAfter = qMax(0, m_indexedBlocks - first - removed);
+
+            enqueue(first, end, qMin(removed, m_indexedBlocks - first));
+            m_indexedBlocks = end + 1 + indexedAfter;
+        }
+    );
+}
+
+QTextDocument* QIdentifierIndex::document() const
+{
+    return m_document;
+}
+
+void QIdentifierIndex::enqueue(int first, int last, int removed)
+{
+    Update update {m_generation.loadAcquire(), first, removed, {}};
+
+    if (m_document)
+    {
+        auto block = m_document->findBlockByNumber(first);
+        for (auto number = first;
+             block.isValid() && number <= last;
+             block = block.next(), ++number)
+        {
+            update.texts.append(block.text());
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_updates.append(std::move(update));
+
+    if (!m_jobRunning)
+    {
+        m_jobRunning = true;
+        m_threadPool.start(new Job(this));
+    }
+}
+
+void QIdentifierIndex::scheduleSnapshot()
+{
+    if (m_snapshotScheduled)
+    {
+        return;
+    }
+
+    m_snapshotScheduled = true;
+    QTimer::singleShot(0, this, &QIdentifierIndex::processSnapshot);
+}
+
+void QIdentifierIndex::processSnapshot()
+{
+    m_snapshotScheduled = false;
+
+    if (m_document == nullptr ||
+        m_indexedBlocks >= m_blockCount)
+    {
+        return;
+    }
+
+    auto last = qMin(m_indexedBlocks + snapshotBlocks, m_blockCount) - 1;
+
+    enqueue(m_indexedBlocks, last, 0);
+    m_indexedBlocks = last + 1;
+
+    scheduleSnapshot();
+}
+
+void QIdentifierIndex::applyUpdate(const Update& update, QHash<QString, int>& changes)
+{
+    if (update.removed < 0)
+    {
+        // Receiver drops identifiers of
+        // previous document itself
+        m_trie.clear();
+        m_blockIdentifiers.clear();
+        changes.clear();
+    }
+
+    auto first = qMin(update.first, m_blockIdentifiers.size());
+    auto removed = qBound(0, update.removed, m_blockIdentifiers.size() - first);
+
+    for (int i = first; i < first + removed; ++i)
+    {
+        for (auto&& identifier : m_blockIdentifiers[i])
+        {
+            if (m_trie.remove(identifier))
+            {
+                --changes[identifier];
+            }
+        }
+    }
+
+    m_blockIdentifiers.remove(first, removed);
+    m_blockIdentifiers.insert(first, update.texts.size(), QStringList());
+
+    for (int i = 0; i < update.texts.size(); ++i)
+    {
+        auto identifiers = splitIdentifiers(update.texts[i]);
+
+        for (auto&& identifier : identifiers)
+        {
+            if (m_trie.insert(identifier))
+            {
+                ++changes[identifier];
+            }
+        }
+
+        m_blockIdentifiers[first + i] = std::move(identifiers);
+    }
+}
+
+void QIdentifierIndex::reportChanges(int generation, const QHash<QString, int>& changes)
+{
+    QStringList added;
+    QStringList removed;
+
+    for (auto it = changes.begin(); it != changes.end(); ++it)
+    {
+        // Identifier, that disappeared and appeared
+        // again, isn't changed
+        if (it.value() > 0)
+        {
+            added.append(it.key());
+        }
+        else if (it.value() < 0)
+        {
+            removed.append(it.key());
+        }
+    }
+
+    if (added.isEmpty() && removed.isEmpty())
+    {
+        return;
+    }
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, added, removed]()
+        {
+            // Document was changed
+            if (generation == m_generation.loadAcquire())
+            {
+                emit identifiersChanged(added, removed);
+            }
+        },
+        Qt::QueuedConnection
+    );
+}
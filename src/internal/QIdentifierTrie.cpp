@@ -0,0 +1,154 @@
+// QCodeEditor
+#include <QIdentifierTrie>
+
+QIdentifierTrie::QIdentifierTrie() :
+    m_nodes(),
+    m_freeNodes(),
+    m_size(0)
+{
+    clear();
+}
+
+bool QIdentifierTrie::insert(const QString& identifier)
+{
+    int node = 0;
+
+    for (auto character : identifier)
+    {
+        auto position = childPosition(m_nodes[node], character);
+        auto& children = m_nodes[node].children;
+
+        if (position < children.size() &&
+            m_nodes[children[position]].character == character)
+        {
+            node = children[position];
+            continue;
+        }
+
+        // Reference to children may be invalidated
+        // by allocation
+        auto child = allocateNode(character, node);
+        m_nodes[node].children.insert(position, child);
+        node = child;
+    }
+
+    if (++m_nodes[node].count > 1)
+    {
+        return false;
+    }
+
+    ++m_size;
+    return true;
+}
+
+bool QIdentifierTrie::remove(const QString& identifier)
+{
+    auto node = findNode(identifier);
+
+    if (node < 0 ||
+        m_nodes[node].count == 0)
+    {
+        return false;
+    }
+
+    if (--m_nodes[node].count > 0)
+    {
+        return false;
+    }
+
+    --m_size;
+
+    // Releasing nodes, that lead only to this identifier
+    while (node != 0 &&
+           m_nodes[node].count == 0 &&
+           m_nodes[node].children.isEmpty())
+    {
+        auto parent = m_nodes[node].parent;
+        auto& children = m_nodes[parent].children;
+
+        children.remove(childPosition(m_nodes[parent], m_nodes[node].character));
+
+        m_freeNodes.append(node);
+        node = parent;
+    }
+
+    return true;
+}
+
+int QIdentifierTrie::count(const QString& identifier) const
+{
+    auto node = findNode(identifier);
+
+    return node < 0 ? 0 : m_nodes[node].count;
+}
+
+int QIdentifierTrie::size() const
+{
+    return m_size;
+}
+
+void QIdentifierTrie::clear()
+{
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_size = 0;
+
+    // Root node
+    m_nodes.append({QChar(), -1, 0, {}});
+}
+
+int QIdentifierTrie::childPosition(const Node& node, QChar character) const
+{
+    int first = 0;
+    int last = node.children.size();
+
+    while (first < last)
+    {
+        auto middle = (first + last) / 2;
+
+        if (m_nodes[node.children[middle]].character < character)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+int QIdentifierTrie::findNode(const QString& identifier) const
+{
+    int node = 0;
+
+    for (auto character : identifier)
+    {
+        auto& children = m_nodes[node].children;
+        auto position = childPosition(m_nodes[node], character);
+
+        if (position >= children.size() ||
+            m_nodes[children[position]].character != character)
+        {
+            return -1;
+        }
+
+        node = children[position];
+    }
+
+    return node;
+}
+
+int QIdentifierTrie::allocateNode(QChar character, int parent)
+{
+    if (!m_freeNodes.isEmpty())
+    {
+        auto node = m_freeNodes.takeLast();
+        m_nodes[node] = {character, parent, 0, {}};
+        return node;
+    }
+
+    m_nodes.append({character, parent, 0, {}});
+    return m_nodes.size() - 1;
+}
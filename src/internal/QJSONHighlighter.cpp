@@ -1,66 +1,164 @@
 // QCodeEditor
 #include <QJSONHighlighter>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
 #include <QSyntaxStyle>
 
+/**
+ * @brief Class, that describes JSON grammar. Block is
+ * tokenized in single pass. String is a key, if it's
+ * followed by colon.
+ */
+class QJSONHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    /**
+     * @brief Method for getting end of string.
+     * Escaped quotes don't end string.
+     * @param data Pointer to block characters.
+     * @param position Position after opening quote.
+     * @param length Block length.
+     * @return Position after closing quote or block
+     * length, if string isn't closed.
+     */
+    static int stringEnd(const ushort* data, int position, int length);
+
+    int m_keywordFormat;
+    int m_numberFormat;
+    int m_stringFormat;
+};
 
 QJSONHighlighter::QJSONHighlighter(QTextDocument* document) :
-    QStyleSyntaxHighlighter(document),
-    m_highlightRules(),
-    m_keyRegex(R"(("[^\r\n:]+?")\s*:)")
+    QStyleSyntaxHighlighter(document)
 {
-    auto keywords = QStringList()
-        << "null" << "true" << "false";
+    setGrammar(QSyntaxGrammar::shared(
+        "JSON",
+        []() -> QSyntaxGrammar* { return new Grammar(); }
+    ));
+}
 
-    for (auto&& keyword : keywords)
-    {
-        m_highlightRules.append({
-            QRegularExpression(QString(R"(\b%1\b)").arg(keyword)),
-            "Keyword"
-        });
-    }
+QJSONHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_keywordFormat(QSyntaxStyle::formatId("Keyword")),
+    m_numberFormat(QSyntaxStyle::formatId("Number")),
+    m_stringFormat(QSyntaxStyle::formatId("String"))
+{
 
-    // Numbers
-    m_highlightRules.append({
-        QRegularExpression(R"(\b(0b|0x){0,1}[\d.']+\b)"),
-        "Number"
-    });
-
-    // Strings
-    m_highlightRules.append({
-        QRegularExpression(R"("[^\n"]*")"),
-        "String"
-    });
 }
 
-void QJSONHighlighter::highlightBlock(const QString& text)
+void QJSONHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
 {
-    for (auto&& rule : m_highlightRules)
+    auto data = reinterpret_cast<const ushort*>(text.constData());
+    auto length = text.size();
+
+    auto isDigit = [](ushort character)
+    {
+        return character >= '0' && character <= '9';
+    };
+
+    auto isLetter = [](ushort character)
     {
-        auto matchIterator = rule.pattern.globalMatch(text);
+        return (character >= 'a' && character <= 'z') ||
+               (character >= 'A' && character <= 'Z');
+    };
 
-        while (matchIterator.hasNext())
+    int position = 0;
+
+    while (position < length)
+    {
+        auto character = data[position];
+        auto start = position;
+
+        if (character == '"')
         {
-            auto match = matchIterator.next();
+            position = stringEnd(data, position + 1, length);
+
+            // Key is followed by colon
+            auto next = position;
+            while (next < length &&
+                   (data[next] == ' ' || data[next] == '\t' || data[next] == '\r'))
+            {
+                ++next;
+            }
 
-            setFormat(
-                match.capturedStart(),
-                match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
+            auto isKey = next < length && data[next] == ':';
+
+            context.setFormat(
+                start,
+                position - start,
+                isKey ? m_keywordFormat : m_stringFormat
             );
         }
-    }
+        else if (isDigit(character) ||
+                 (character == '-' && position + 1 < length && isDigit(data[position + 1])))
+        {
+            ++position;
+
+            while (position < length)
+            {
+                character = data[position];
+
+                if (isDigit(character) ||
+                    character == '.' ||
+                    character == 'e' ||
+                    character == 'E' ||
+                    ((character == '+' || character == '-') &&
+                     (data[position - 1] == 'e' || data[position - 1] == 'E')))
+                {
+                    ++position;
+                    continue;
+                }
 
-    // Special treatment for key regex
-    auto matchIterator = m_keyRegex.globalMatch(text);
+                break;
+            }
+
+            context.setFormat(start, position - start, m_numberFormat);
+        }
+        else if (isLetter(character))
+        {
+            while (position < length &&
+                   (isLetter(data[position]) || isDigit(data[position]) || data[position] == '_'))
+            {
+                ++position;
+            }
+
+            auto word = QStringRef(&text, start, position - start);
+
+            if (word == QLatin1String("null") ||
+                word == QLatin1String("true") ||
+                word == QLatin1String("false"))
+            {
+                context.setFormat(start, position - start, m_keywordFormat);
+            }
+        }
+        else
+        {
+            ++position;
+        }
+    }
+}
 
-    while (matchIterator.hasNext())
+int QJSONHighlighter::Grammar::stringEnd(const ushort* data, int position, int length)
+{
+    while (position < length)
     {
-        auto match = matchIterator.next();
+        auto character = data[position];
 
-        setFormat(
-            match.capturedStart(1),
-            match.capturedLength(1),
-            syntaxStyle()->getFormat("Keyword")
-        );
+        if (character == '"')
+        {
+            return position + 1;
+        }
+
+        // Escaped character is skipped
+        position += character == '\\' ? 2 : 1;
     }
+
+    return length;
 }
@@ -0,0 +1,103 @@
+// QCodeEditor
+#include <QKeywordMatcher>
+
+QKeywordMatcher::QKeywordMatcher() :
+    m_nodes()
+{
+    // Root node
+    m_nodes.append({0, -1, -1, -1});
+}
+
+bool QKeywordMatcher::isIdentifier(const QString& name)
+{
+    if (name.isEmpty())
+    {
+        return false;
+    }
+
+    for (auto&& c : name)
+    {
+        if (!isWordCharacter(c))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void QKeywordMatcher::insert(const QString& keyword, int formatId)
+{
+    if (!isIdentifier(keyword) || formatId < 0)
+    {
+        return;
+    }
+
+    int node = 0;
+    for (auto&& c : keyword)
+    {
+        auto character = c.unicode();
+
+        // Searching for place in sorted children list
+        int previous = -1;
+        int child = m_nodes[node].firstChild;
+        while (child >= 0 && m_nodes[child].character < character)
+        {
+            previous = child;
+            child = m_nodes[child].nextSibling;
+        }
+
+        if (child < 0 || m_nodes[child].character != character)
+        {
+            auto created = m_nodes.size();
+            m_nodes.append({character, -1, child, -1});
+
+            if (previous < 0)
+            {
+                m_nodes[node].firstChild = created;
+            }
+            else
+            {
+                m_nodes[previous].nextSibling = created;
+            }
+
+            child = created;
+        }
+
+        node = child;
+    }
+
+    m_nodes[node].format = formatId;
+}
+
+bool QKeywordMatcher::isEmpty() const
+{
+    // Only root node
+    return m_nodes.size() == 1;
+}
+
+int QKeywordMatcher::find(const QChar* data, int length) const
+{
+    auto nodes = m_nodes.constData();
+
+    int node = 0;
+    for (int i = 0; i < length; ++i)
+    {
+        auto character = data[i].unicode();
+
+        int child = nodes[node].firstChild;
+        while (child >= 0 && nodes[child].character < character)
+        {
+            child = nodes[child].nextSibling;
+        }
+
+        if (child < 0 || nodes[child].character != character)
+        {
+            return -1;
+        }
+
+        node = child;
+    }
+
+    return nodes[node].format;
+}
@@ -0,0 +1,62 @@
+// QCodeEditor
+#include <QLanguageTable>
+
+const QLanguageTable* QLanguageTable::find(const QString& name)
+{
+    for (int i = 0; i < builtinCount; ++i)
+    {
+        if (name == QLatin1String(builtin[i].name))
+        {
+            return &builtin[i];
+        }
+    }
+
+    return nullptr;
+}
+
+QStringList QLanguageTable::keys() const
+{
+    QStringList result;
+
+    for (int i = 0; i < count; ++i)
+    {
+        result << QString::fromLatin1(sections[i].key);
+    }
+
+    return result;
+}
+
+QStringList QLanguageTable::names(const QString& key) const
+{
+    QStringList result;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (key != QLatin1String(sections[i].key))
+        {
+            continue;
+        }
+
+        for (int j = 0; j < sections[i].count; ++j)
+        {
+            result << QString::fromUtf8(sections[i].names[j]);
+        }
+    }
+
+    return result;
+}
+
+QStringList QLanguageTable::allNames() const
+{
+    QStringList result;
+
+    for (int i = 0; i < count; ++i)
+    {
+        for (int j = 0; j < sections[i].count; ++j)
+        {
+            result << QString::fromUtf8(sections[i].names[j]);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,731 @@
+// QCodeEditor
+#include <QLexerDFA>
+
+// Qt
+#include <QMap>
+
+// std
+#include <algorithm>
+
+/**
+ * @brief Class, that describes parser of rule pattern.
+ * It builds nondeterministic automaton fragment with
+ * Thompson's construction.
+ */
+class QLexerDFA::Parser
+{
+public:
+
+    Parser(QLexerDFA& automaton, const QString& pattern) :
+        m_automaton(automaton),
+        m_pattern(pattern),
+        m_position(0),
+        m_failed(false)
+    {}
+
+    bool parse(Fragment& fragment)
+    {
+        fragment = parseAlternation();
+
+        return !m_failed && m_position == m_pattern.size();
+    }
+
+private:
+
+    /**
+     * @brief Maximal number of repetitions in
+     * `{n,m}` quantifier.
+     */
+    static const int maxRepetitions = 64;
+
+    bool atEnd() const
+    {
+        return m_position >= m_pattern.size();
+    }
+
+    bool consume(QChar character)
+    {
+        if (atEnd() || m_pattern[m_position] != character)
+        {
+            return false;
+        }
+
+        ++m_position;
+        return true;
+    }
+
+    void connect(int from, int to)
+    {
+        m_automaton.m_nfa[from].epsilon.append(to);
+    }
+
+    Fragment empty()
+    {
+        auto state = m_automaton.addNfaState();
+        return {state, state};
+    }
+
+    Fragment characters(const QCharacterSet& set)
+    {
+        auto start = m_automaton.addNfaState();
+        auto end = m_automaton.addNfaState();
+
+        m_automaton.m_nfa[start].characters = set;
+        m_automaton.m_nfa[start].next = end;
+
+        return {start, end};
+    }
+
+    Fragment parseAlternation()
+    {
+        auto fragment = parseSequence();
+
+        if (atEnd() || m_pattern[m_position] != '|')
+        {
+            return fragment;
+        }
+
+        auto start = m_automaton.addNfaState();
+        auto end = m_automaton.addNfaState();
+
+        connect(start, fragment.start);
+        connect(fragment.end, end);
+
+        while (!m_failed && consume('|'))
+        {
+            fragment = parseSequence();
+
+            connect(start, fragment.start);
+            connect(fragment.end, end);
+        }
+
+        return {start, end};
+    }
+
+    Fragment parseSequence()
+    {
+        auto result = empty();
+
+        while (!m_failed &&
+               !atEnd() &&
+               m_pattern[m_position] != '|' &&
+               m_pattern[m_position] != ')')
+        {
+            auto fragment = parseRepetition();
+
+            connect(result.end, fragment.start);
+            result.end = fragment.end;
+        }
+
+        return result;
+    }
+
+    Fragment parseRepetition()
+    {
+        auto atomStart = m_position;
+        auto fragment = parseAtom();
+
+        if (m_failed)
+        {
+            return fragment;
+        }
+
+        int min = 1;
+        int max = 1;
+
+        if (consume('*'))
+        {
+            min = 0;
+            max = -1;
+        }
+        else if (consume('+'))
+        {
+            max = -1;
+        }
+        else if (consume('?'))
+        {
+            min = 0;
+        }
+        else if (!parseCount(min, max))
+        {
+            return fragment;
+        }
+
+        // Lazy and possessive quantifiers
+        // match the same language
+        if (!consume('?'))
+        {
+            consume('+');
+        }
+
+        if (m_failed)
+        {
+            return fragment;
+        }
+
+        auto quantifierEnd = m_position;
+
+        // Copy of atom is made by parsing it again
+        bool firstCopy = true;
+        auto copy = [&]() -> Fragment
+        {
+            if (firstCopy)
+            {
+                firstCopy = false;
+                return fragment;
+            }
+
+            m_position = atomStart;
+            auto result = parseAtom();
+            m_position = quantifierEnd;
+
+            return result;
+        };
+
+        auto result = empty();
+
+        for (int i = 0; i < min; ++i)
+        {
+            auto atom = copy();
+
+            connect(result.end, atom.start);
+            result.end = atom.end;
+        }
+
+        auto end = m_automaton.addNfaState();
+
+        if (max < 0)
+        {
+            auto atom = copy();
+
+            connect(result.end, atom.start);
+            connect(atom.end, atom.start);
+            connect(atom.end, end);
+        }
+        else
+        {
+            for (int i = min; i < max; ++i)
+            {
+                auto atom = copy();
+
+                connect(result.end, end);
+                connect(result.end, atom.start);
+                result.end = atom.end;
+            }
+        }
+
+        connect(result.end, end);
+        result.end = end;
+
+        return result;
+    }
+
+    /**
+     * @brief Method for parsing `{n}`, `{n,}`
+     * or `{n,m}` quantifier.
+     * @return Is there quantifier.
+     */
+    bool parseCount(int& min, int& max)
+    {
+        if (atEnd() || m_pattern[m_position] != '{')
+        {
+            return false;
+        }
+
+        auto end = m_pattern.indexOf('}', m_position);
+
+        if (end < 0)
+        {
+            return false;
+        }
+
+        auto parts = m_pattern.mid(m_position + 1, end - m_position - 1).split(',');
+
+        if (parts.size() > 2)
+        {
+            return false;
+        }
+
+        bool valid = false;
+        min = parts[0].toInt(&valid);
+
+        if (!valid)
+        {
+            return false;
+        }
+
+        max = min;
+
+        if (parts.size() == 2)
+        {
+            max = parts[1].isEmpty() ? -1 : parts[1].toInt(&valid);
+
+            if (!valid)
+            {
+                return false;
+            }
+        }
+
+        if (min > maxRepetitions ||
+            max > maxRepetitions ||
+            (max >= 0 && max < min))
+        {
+            m_failed = true;
+        }
+
+        m_position = end + 1;
+        return true;
+    }
+
+    Fragment parseAtom()
+    {
+        auto character = m_pattern[m_position++];
+
+        switch (character.unicode())
+        {
+        case '(':
+        {
+            // Only non capturing groups are supported,
+            // because there are no captures anyway
+            if (consume('?') && !consume(':'))
+            {
+                m_failed = true;
+                return empty();
+            }
+
+            auto fragment = parseAlternation();
+
+            if (!consume(')'))
+            {
+                m_failed = true;
+            }
+
+            return fragment;
+        }
+
+        case '[':
+            return characters(parseClass());
+
+        case '.':
+            return characters(QCharacterSet::all());
+
+        case '\\':
+            return characters(parseEscape());
+
+        case '*':
+        case '+':
+        case '?':
+        case '^':
+        case '$':
+            m_failed = true;
+            return empty();
+        }
+
+        QCharacterSet set;
+        set.insert(character);
+
+        return characters(set);
+    }
+
+    QCharacterSet parseClass()
+    {
+        QCharacterSet result;
+
+        bool negated = consume('^');
+        bool firstItem = true;
+
+        while (!m_failed && !atEnd())
+        {
+            auto character = m_pattern[m_position++];
+
+            if (character == ']' && !firstItem)
+            {
+                return negated ? result.inverted() : result;
+            }
+
+            firstItem = false;
+
+            if (character == '\\')
+            {
+                auto escaped = parseEscape();
+
+                // Only single character can start range
+                if (!isSingleEscape())
+                {
+                    result.unite(escaped);
+                    continue;
+                }
+
+                character = m_pattern[m_position - 1];
+                character = unescape(character);
+            }
+
+            if (m_position + 1 < m_pattern.size() &&
+                m_pattern[m_position] == '-' &&
+                m_pattern[m_position + 1] != ']')
+            {
+                ++m_position;
+
+                auto last = m_pattern[m_position++];
+
+                if (last == '\\')
+                {
+                    parseEscape();
+
+                    if (!isSingleEscape())
+                    {
+                        m_failed = true;
+                        break;
+                    }
+
+                    last = unescape(m_pattern[m_position - 1]);
+                }
+
+                if (last < character)
+                {
+                    m_failed = true;
+                    break;
+                }
+
+                result.insert(character, last);
+                continue;
+            }
+
+            result.insert(character);
+        }
+
+        m_failed = true;
+        return result;
+    }
+
+    /**
+     * @brief Method for checking if last parsed
+     * escape is a single character.
+     */
+    bool isSingleEscape() const
+    {
+        switch (m_pattern[m_position - 1].unicode())
+        {
+        case 'd':
+        case 'w':
+        case 's':
+        case 'D':
+        case 'W':
+        case 'S':
+            return false;
+        }
+
+        return true;
+    }
+
+    static QChar unescape(QChar character)
+    {
+        switch (character.unicode())
+        {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case 'a': return '\a';
+        case 'e': return '\x1b';
+        }
+
+        return character;
+    }
+
+    QCharacterSet parseEscape()
+    {
+        QCharacterSet result;
+
+        if (atEnd())
+        {
+            m_failed = true;
+            return result;
+        }
+
+        auto character = m_pattern[m_position++];
+
+        switch (character.unicode())
+        {
+        case 'd':
+        case 'D':
+            result.insert('0', '9');
+            break;
+
+        case 'w':
+        case 'W':
+            result.insert('a', 'z');
+            result.insert('A', 'Z');
+            result.insert('0', '9');
+            result.insert('_');
+            break;
+
+        case 's':
+        case 'S':
+            result.insert('\t', '\r');
+            result.insert(' ');
+            break;
+
+        case 'n':
+        case 't':
+        case 'r':
+        case 'f':
+        case 'v':
+        case 'a':
+        case 'e':
+            result.insert(unescape(character));
+            break;
+
+        default:
+            // Hexadecimal, Unicode properties,
+            // back references, assertions, etc.
+            if (character.isLetterOrNumber())
+            {
+                m_failed = true;
+                return result;
+            }
+
+            result.insert(character);
+            break;
+        }
+
+        if (character.isUpper())
+        {
+            return result.inverted();
+        }
+
+        return result;
+    }
+
+    QLexerDFA& m_automaton;
+    const QString& m_pattern;
+    int m_position;
+    bool m_failed;
+};
+
+QLexerDFA::QLexerDFA() :
+    m_nfa(),
+    m_ruleCount(0),
+    m_transitions(),
+    m_accept(),
+    m_compiled(false)
+{
+    // Start state
+    addNfaState();
+}
+
+int QLexerDFA::addRule(const QString& pattern)
+{
+    if (m_compiled || pattern.isEmpty())
+    {
+        return -1;
+    }
+
+    Parser parser(*this, pattern);
+    Fragment fragment = {-1, -1};
+
+    // States of failed rule stay unreachable
+    if (!parser.parse(fragment))
+    {
+        return -1;
+    }
+
+    return addFragment(fragment);
+}
+
+int QLexerDFA::addLiteral(const QString& literal)
+{
+    if (m_compiled || literal.isEmpty())
+    {
+        return -1;
+    }
+
+    auto start = addNfaState();
+    auto end = start;
+
+    for (auto&& character : literal)
+    {
+        auto next = addNfaState();
+
+        m_nfa[end].characters.insert(character);
+        m_nfa[end].next = next;
+
+        end = next;
+    }
+
+    return addFragment({start, end});
+}
+
+bool QLexerDFA::compile()
+{
+    if (m_compiled)
+    {
+        return true;
+    }
+
+    m_transitions.clear();
+    m_accept.clear();
+
+    QMap<QVector<int>, int> ids;
+    QVector<QVector<int>> sets;
+
+    auto start = closure({0});
+    ids.insert(start, 0);
+    sets.append(start);
+
+    // Subset construction
+    for (int current = 0; current < sets.size(); ++current)
+    {
+        auto states = sets[current];
+
+        int accept = -1;
+        for (auto state : states)
+        {
+            auto rule = m_nfa[state].rule;
+
+            if (rule >= 0 && (accept < 0 || rule < accept))
+            {
+                accept = rule;
+            }
+        }
+
+        m_accept.append(accept);
+
+        for (int symbol = 0; symbol < symbolCount; ++symbol)
+        {
+            auto character = QChar(symbol < 0x80 ? symbol : 0x80);
+
+            QVector<int> next;
+            for (auto state : states)
+            {
+                if (m_nfa[state].next >= 0 &&
+                    m_nfa[state].characters.contains(character))
+                {
+                    next.append(m_nfa[state].next);
+                }
+            }
+
+            if (next.isEmpty())
+            {
+                m_transitions.append(-1);
+                continue;
+            }
+
+            next = closure(next);
+
+            auto found = ids.find(next);
+
+            if (found != ids.end())
+            {
+                m_transitions.append(found.value());
+                continue;
+            }
+
+            if (sets.size() >= maxStateCount)
+            {
+                m_transitions.clear();
+                m_accept.clear();
+                return false;
+            }
+
+            ids.insert(next, sets.size());
+            m_transitions.append(sets.size());
+            sets.append(next);
+        }
+    }
+
+    // Automaton isn't needed anymore
+    m_nfa.clear();
+    m_compiled = true;
+
+    return true;
+}
+
+int QLexerDFA::match(const QChar* data, int length, int& rule) const
+{
+    rule = -1;
+
+    if (!m_compiled)
+    {
+        return 0;
+    }
+
+    auto transitions = m_transitions.constData();
+    auto accept = m_accept.constData();
+
+    int state = 0;
+    int result = 0;
+
+    for (int i = 0; i < length; ++i)
+    {
+        state = transitions[state * symbolCount + symbol(data[i])];
+
+        if (state < 0)
+        {
+            break;
+        }
+
+        if (accept[state] >= 0)
+        {
+            result = i + 1;
+            rule = accept[state];
+        }
+    }
+
+    return result;
+}
+
+bool QLexerDFA::isCompiled() const
+{
+    return m_compiled;
+}
+
+int QLexerDFA::symbol(QChar character)
+{
+    auto code = character.unicode();
+
+    return code < 0x80 ? code : 0x80;
+}
+
+int QLexerDFA::addNfaState()
+{
+    m_nfa.append({QCharacterSet(), -1, QVector<int>(), -1});
+
+    return m_nfa.size() - 1;
+}
+
+int QLexerDFA::addFragment(const Fragment& fragment)
+{
+    m_nfa[0].epsilon.append(fragment.start);
+    m_nfa[fragment.end].rule = m_ruleCount;
+
+    return m_ruleCount++;
+}
+
+QVector<int> QLexerDFA::closure(QVector<int> states) const
+{
+    QVector<bool> visited(m_nfa.size(), false);
+
+    for (auto state : states)
+    {
+        visited[state] = true;
+    }
+
+    // States vector is used as stack
+    for (int i = 0; i < states.size(); ++i)
+    {
+        for (auto next : m_nfa[states[i]].epsilon)
+        {
+            if (!visited[next])
+            {
+                visited[next] = true;
+                states.append(next);
+            }
+        }
+    }
+
+    std::sort(states.begin(), states.end());
+
+    return states;
+}
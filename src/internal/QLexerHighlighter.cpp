@@ -0,0 +1,401 @@
+// QCodeEditor
+#include <QLexerHighlighter>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
+#include <QSyntaxStyle>
+#include <QKeywordMatcher>
+#include <QLexerDFA>
+
+// Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QVector>
+#include <QXmlStreamReader>
+
+/**
+ * @brief Class, that describes grammar, compiled
+ * from language definition.
+ */
+class QLexerHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    /**
+     * @brief Method for parsing and compiling
+     * language definition.
+     * @param device Pointer to device.
+     * @return Success.
+     */
+    bool load(QIODevice* device);
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    /**
+     * @brief Structure, that describes region.
+     */
+    struct Region
+    {
+        QString end;
+        QChar escape;
+        bool multiline;
+        int formatId;
+    };
+
+    /**
+     * @brief Structure, that describes what
+     * automaton rule matches.
+     */
+    struct Rule
+    {
+        enum Type
+        {
+            Token,
+            Identifier,
+            RegionBegin
+        };
+
+        Type type;
+        int formatId;
+        int region;
+    };
+
+    /**
+     * @brief Method for adding automaton rule.
+     * @return Success.
+     */
+    bool addRule(int id, const Rule& rule);
+
+    /**
+     * @brief Method for getting end of region.
+     * @param text Block text.
+     * @param position Position to start search from.
+     * @param region Region.
+     * @return Position after region end or -1.
+     */
+    static int regionEnd(const QString& text, int position, const Region& region);
+
+    QLexerDFA m_automaton;
+    QVector<Rule> m_rules;
+    QVector<Region> m_regions;
+    QKeywordMatcher m_keywordMatcher;
+};
+
+QLexerHighlighter::QLexerHighlighter(QTextDocument* document) :
+    QStyleSyntaxHighlighter(document)
+{
+
+}
+
+bool QLexerHighlighter::load(const QString& fileName)
+{
+    Q_INIT_RESOURCE(qcodeeditor_resources);
+
+    auto path = fileName.startsWith(':') ?
+        fileName :
+        QFileInfo(fileName).absoluteFilePath();
+
+    auto grammar = QSyntaxGrammar::shared(
+        "QLexerHighlighter:" + path,
+        [&path]() -> QSyntaxGrammar*
+        {
+            QFile file(path);
+
+            if (!file.open(QIODevice::ReadOnly))
+            {
+                return nullptr;
+            }
+
+            auto grammar = new Grammar();
+
+            if (!grammar->load(&file))
+            {
+                delete grammar;
+                return nullptr;
+            }
+
+            return grammar;
+        }
+    );
+
+    if (!grammar)
+    {
+        return false;
+    }
+
+    setGrammar(grammar);
+    rehighlight();
+
+    return true;
+}
+
+bool QLexerHighlighter::load(QIODevice* device)
+{
+    QSharedPointer<Grammar> grammar(new Grammar());
+
+    if (device == nullptr ||
+        !grammar->load(device))
+    {
+        return false;
+    }
+
+    setGrammar(grammar);
+    rehighlight();
+
+    return true;
+}
+
+bool QLexerHighlighter::isLoaded() const
+{
+    return !grammar().isNull();
+}
+
+QLexerHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_automaton(),
+    m_rules(),
+    m_regions(),
+    m_keywordMatcher()
+{
+
+}
+
+bool QLexerHighlighter::Grammar::load(QIODevice* device)
+{
+    QXmlStreamReader reader(device);
+
+    QString key;
+    QString identifierPattern = "[A-Za-z_][A-Za-z0-9_]*";
+    bool readName = false;
+
+    while (!reader.atEnd() && !reader.hasError())
+    {
+        auto type = reader.readNext();
+
+        if (type == QXmlStreamReader::TokenType::Characters &&
+            readName)
+        {
+            auto name = reader.text().toString();
+            auto formatId = QSyntaxStyle::formatId(key);
+            readName = false;
+
+            if (QKeywordMatcher::isIdentifier(name))
+            {
+                m_keywordMatcher.insert(name, formatId);
+                continue;
+            }
+
+            // Other names are patterns, like in QLanguage
+            // files of built-in highlighters
+            if (!addRule(m_automaton.addRule(name), {Rule::Token, formatId, -1}))
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        if (type != QXmlStreamReader::TokenType::StartElement)
+        {
+            continue;
+        }
+
+        auto attributes = reader.attributes();
+        auto format = QSyntaxStyle::formatId(attributes.value("format").toString());
+
+        if (reader.name() == "section")
+        {
+            key = attributes.value("name").toString();
+        }
+        else if (reader.name() == "name")
+        {
+            readName = true;
+        }
+        else if (reader.name() == "identifier")
+        {
+            identifierPattern = attributes.value("pattern").toString();
+        }
+        else if (reader.name() == "token")
+        {
+            auto id = m_automaton.addRule(attributes.value("pattern").toString());
+
+            if (!addRule(id, {Rule::Token, format, -1}))
+            {
+                return false;
+            }
+        }
+        else if (reader.name() == "region")
+        {
+            auto escape = attributes.value("escape").toString();
+
+            m_regions.append({
+                attributes.value("end").toString(),
+                escape.isEmpty() ? QChar() : escape.at(0),
+                attributes.value("multiline") == "true",
+                format
+            });
+
+            auto id = m_automaton.addLiteral(attributes.value("begin").toString());
+
+            if (!addRule(id, {Rule::RegionBegin, format, m_regions.size() - 1}))
+            {
+                return false;
+            }
+        }
+    }
+
+    if (reader.hasError())
+    {
+        return false;
+    }
+
+    // Identifiers have the lowest priority, so
+    // tokens, that look like identifiers, win
+    auto id = m_automaton.addRule(identifierPattern);
+
+    if (!addRule(id, {Rule::Identifier, -1, -1}))
+    {
+        return false;
+    }
+
+    return m_automaton.compile();
+}
+
+bool QLexerHighlighter::Grammar::addRule(int id, const Rule& rule)
+{
+    // Invalid pattern
+    if (id < 0)
+    {
+        return false;
+    }
+
+    m_rules.resize(id + 1);
+    m_rules[id] = rule;
+
+    return true;
+}
+
+void QLexerHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
+{
+    auto data = text.constData();
+    auto length = text.size();
+
+    int position = 0;
+
+    context.setCurrentBlockState(0);
+
+    // Region, that's open in previous block
+    auto state = context.previousBlockState();
+
+    if (state > 0 && state <= m_regions.size())
+    {
+        auto& region = m_regions[state - 1];
+        auto end = regionEnd(text, 0, region);
+
+        if (end < 0)
+        {
+            context.setFormat(0, length, region.formatId);
+            context.setCurrentBlockState(state);
+            return;
+        }
+
+        context.setFormat(0, end, region.formatId);
+        position = end;
+    }
+
+    while (position < length)
+    {
+        int id = -1;
+        auto matched = m_automaton.match(data + position, length - position, id);
+
+        if (matched == 0)
+        {
+            ++position;
+            continue;
+        }
+
+        auto& rule = m_rules[id];
+
+        switch (rule.type)
+        {
+        case Rule::Token:
+            context.setFormat(position, matched, rule.formatId);
+            position += matched;
+            break;
+
+        case Rule::Identifier:
+        {
+            auto formatId = m_keywordMatcher.find(data + position, matched);
+
+            if (formatId >= 0)
+            {
+                context.setFormat(position, matched, formatId);
+            }
+
+            position += matched;
+            break;
+        }
+
+        case Rule::RegionBegin:
+        {
+            auto& region = m_regions[rule.region];
+            auto end = region.end.isEmpty() ?
+                length :
+                regionEnd(text, position + matched, region);
+
+            if (end < 0)
+            {
+                end = length;
+
+                if (region.multiline)
+                {
+                    context.setCurrentBlockState(rule.region + 1);
+                }
+            }
+
+            context.setFormat(position, end - position, region.formatId);
+            position = end;
+            break;
+        }
+        }
+    }
+}
+
+int QLexerHighlighter::Grammar::regionEnd(const QString& text, int position, const Region& region)
+{
+    if (region.escape.isNull())
+    {
+        auto end = text.indexOf(region.end, position);
+
+        return end < 0 ? -1 : end + region.end.size();
+    }
+
+    auto first = region.end[0];
+    auto length = text.size();
+
+    while (position < length)
+    {
+        auto character = text[position];
+
+        // Escaped character is skipped
+        if (character == region.escape)
+        {
+            position += 2;
+            continue;
+        }
+
+        if (character == first &&
+            text.midRef(position, region.end.size()) == region.end)
+        {
+            return position + region.end.size();
+        }
+
+        ++position;
+    }
+
+    return -1;
+}
@@ -10,13 +10,59 @@
 #include <QTextBlock>
 #include <QScrollBar>
 #include <QAbstractTextDocumentLayout>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QPolygon>
+
+/**
+ * @brief Static function for skipping blocks, that are
+ * hidden by folded region. Hidden blocks have empty rects,
+ * so walking over them would visit whole region.
+ * @param blockNumber Number of block, it's updated
+ * to number of returned block.
+ * @return Block itself, if it's visible, or first
+ * block after hidden range.
+ */
+static QTextBlock skipHiddenBlocks(const QFoldingTree& foldingTree,
+                                   QTextDocument* document,
+                                   const QTextBlock& block,
+                                   int& blockNumber)
+{
+    if (block.isVisible())
+    {
+        return block;
+    }
+
+    auto ranges = foldingTree.hiddenRanges(blockNumber, blockNumber);
+
+    if (ranges.isEmpty() ||
+        ranges.first().second < blockNumber)
+    {
+        return block;
+    }
+
+    blockNumber = ranges.first().second + 1;
+
+    return document->findBlockByNumber(blockNumber);
+}
 
 QLineNumberArea::QLineNumberArea(QCodeEditor* parent) :
     QWidget(parent),
     m_syntaxStyle(nullptr),
-    m_codeEditParent(parent)
+    m_codeEditParent(parent),
+    m_backgroundColor(),
+    m_currentLineColor(),
+    m_otherLinesColor(),
+    m_font(),
+    m_digits(0),
+    m_folding(false),
+    m_lineHeight(0),
+    m_width(0),
+    m_digitWidths(),
+    m_digitTexts()
 {
-
+    // Painting only exposed parts on scroll
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 QSize QLineNumberArea::sizeHint() const
@@ -26,6 +72,32 @@ QSize QLineNumberArea::sizeHint() const
         return QWidget::sizeHint();
     }
 
+    updateMetrics();
+
+    return {m_width, 0};
+}
+
+void QLineNumberArea::setSyntaxStyle(QSyntaxStyle* style)
+{
+    m_syntaxStyle = style;
+
+    if (m_syntaxStyle)
+    {
+        m_backgroundColor  = m_syntaxStyle->getFormat("Text").background().color();
+        m_currentLineColor = m_syntaxStyle->getFormat("CurrentLineNumber").foreground().color();
+        m_otherLinesColor  = m_syntaxStyle->getFormat("LineNumber").foreground().color();
+    }
+
+    update();
+}
+
+QSyntaxStyle* QLineNumberArea::syntaxStyle() const
+{
+    return m_syntaxStyle;
+}
+
+void QLineNumberArea::updateMetrics() const
+{
     // Calculating width
     int digits = 1;
     int max = qMax(1, m_codeEditParent->document()->blockCount());
@@ -34,19 +106,80 @@ QSize QLineNumberArea::sizeHint() const
         ++digits;
     }
 
-    int space = 13 + m_codeEditParent->fontMetrics().horizontalAdvance(QLatin1Char('9')) * digits;
+    auto font = m_codeEditParent->font();
+    auto folding = m_codeEditParent->foldingEnabled();
+
+    if (digits == m_digits &&
+        font == m_font &&
+        folding == m_folding)
+    {
+        return;
+    }
 
-    return {space, 0};
+    if (font != m_font)
+    {
+        QFontMetrics metrics(font);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            QString digit(QChar('0' + i));
+
+            m_digitWidths[i] = metrics.horizontalAdvance(digit);
+
+            m_digitTexts[i].setText(digit);
+            m_digitTexts[i].setTextFormat(Qt::PlainText);
+            m_digitTexts[i].prepare(QTransform(), font);
+        }
+        m_font = font;
+    }
+
+    m_lineHeight = QFontMetrics(font).height();
+
+    m_digits = digits;
+    m_folding = folding;
+    m_width = 13 + m_digitWidths[9] * digits + foldMarkerWidth();
 }
 
-void QLineNumberArea::setSyntaxStyle(QSyntaxStyle* style)
+int QLineNumberArea::foldMarkerWidth() const
 {
-    m_syntaxStyle = style;
+    return m_folding ? m_lineHeight : 0;
 }
 
-QSyntaxStyle* QLineNumberArea::syntaxStyle() const
+void QLineNumberArea::drawFoldMarker(QPainter& painter, bool folded, int top) const
 {
-    return m_syntaxStyle;
+    auto size = m_lineHeight / 2;
+    auto left = m_width - foldMarkerWidth() + (foldMarkerWidth() - size) / 2;
+    top += (m_lineHeight - size) / 2;
+
+    QPolygon triangle;
+
+    if (folded)
+    {
+        triangle << QPoint(left, top)
+                 << QPoint(left + size, top + size / 2)
+                 << QPoint(left, top + size);
+    }
+    else
+    {
+        triangle << QPoint(left, top)
+                 << QPoint(left + size, top)
+                 << QPoint(left + size / 2, top + size);
+    }
+
+    painter.drawPolygon(triangle);
+}
+
+void QLineNumberArea::drawNumber(QPainter& painter, int number, int right, int top) const
+{
+    do
+    {
+        auto digit = number % 10;
+        number /= 10;
+
+        right -= m_digitWidths[digit];
+        painter.drawStaticText(right, top, m_digitTexts[digit]);
+    }
+    while (number > 0);
 }
 
 void QLineNumberArea::paintEvent(QPaintEvent* event)
@@ -56,41 +189,125 @@ void QLineNumberArea::paintEvent(QPaintEvent* event)
     // Clearing rect to update
     painter.fillRect(
         event->rect(),
-        m_syntaxStyle->getFormat("Text").background().color()
+        m_backgroundColor
     );
 
+    updateMetrics();
+
+    auto document    = m_codeEditParent->document();
+    auto layout      = document->documentLayout();
+    auto scroll      = m_codeEditParent->verticalScrollBar()->value();
+    auto currentLine = m_codeEditParent->textCursor().blockNumber();
+
     auto blockNumber = m_codeEditParent->getFirstVisibleBlock();
-    auto block       = m_codeEditParent->document()->findBlockByNumber(blockNumber);
-    auto top         = (int) m_codeEditParent->document()->documentLayout()->blockBoundingRect(block).translated(0, -m_codeEditParent->verticalScrollBar()->value()).top();
-    auto bottom      = top + (int) m_codeEditParent->document()->documentLayout()->blockBoundingRect(block).height();
+    auto block       = document->findBlockByNumber(blockNumber);
 
-    auto currentLine = m_syntaxStyle->getFormat("CurrentLineNumber").foreground().color();
-    auto otherLines  = m_syntaxStyle->getFormat("LineNumber").foreground().color();
+    painter.setFont(m_font);
+    painter.setPen(m_otherLinesColor);
 
-    painter.setFont(m_codeEditParent->font());
+    // Right edge of numbers, as with right aligned
+    // text shifted by 5 pixels
+    auto right = m_width - foldMarkerWidth() - 5;
 
-    while (block.isValid() && top <= event->rect().bottom())
+    auto& foldingTree = m_codeEditParent->foldingTree();
+
+    while (block.isValid())
     {
+        block = skipHiddenBlocks(foldingTree, document, block, blockNumber);
+
+        if (!block.isValid())
+        {
+            break;
+        }
+
+        auto rect   = layout->blockBoundingRect(block);
+        auto top    = (int) rect.top() - scroll;
+        auto bottom = top + (int) rect.height();
+
+        if (top > event->rect().bottom())
+        {
+            break;
+        }
+
         if (block.isVisible() && bottom >= event->rect().top())
         {
-            QString number = QString::number(blockNumber + 1);
-
-            auto isCurrentLine = m_codeEditParent->textCursor().blockNumber() == blockNumber;
-            painter.setPen(isCurrentLine ? currentLine : otherLines);
-
-            painter.drawText(
-                -5,
-                top,
-                sizeHint().width(),
-                m_codeEditParent->fontMetrics().height(),
-                Qt::AlignRight,
-                number
-            );
+            auto isCurrentLine = blockNumber == currentLine;
+
+            if (isCurrentLine)
+            {
+                painter.setPen(m_currentLineColor);
+            }
+
+            drawNumber(painter, blockNumber + 1, right, top);
+
+            if (isCurrentLine)
+            {
+                painter.setPen(m_otherLinesColor);
+            }
+
+            auto region = m_folding ?
+                foldingTree.regionAt(blockNumber) :
+                QFoldingTree::Region{-1, -1, QFoldingTree::Kind::Braces, false};
+
+            if (region.start >= 0)
+            {
+                painter.setBrush(m_otherLinesColor);
+                drawFoldMarker(painter, region.folded, top);
+                painter.setBrush(Qt::NoBrush);
+            }
+        }
+
+        block = block.next();
+        ++blockNumber;
+    }
+}
+
+void QLineNumberArea::mousePressEvent(QMouseEvent* event)
+{
+    updateMetrics();
+
+    if (!m_folding ||
+        event->button() != Qt::LeftButton ||
+        event->pos().x() < m_width - foldMarkerWidth())
+    {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    auto document = m_codeEditParent->document();
+    auto layout   = document->documentLayout();
+    auto scroll   = m_codeEditParent->verticalScrollBar()->value();
+
+    auto blockNumber = m_codeEditParent->getFirstVisibleBlock();
+    auto block       = document->findBlockByNumber(blockNumber);
+
+    auto& foldingTree = m_codeEditParent->foldingTree();
+
+    while (block.isValid())
+    {
+        block = skipHiddenBlocks(foldingTree, document, block, blockNumber);
+
+        if (!block.isValid())
+        {
+            break;
+        }
+
+        auto rect = layout->blockBoundingRect(block);
+        auto top  = (int) rect.top() - scroll;
+
+        if (top > event->pos().y())
+        {
+            break;
+        }
+
+        if (block.isVisible() &&
+            top + (int) rect.height() > event->pos().y())
+        {
+            m_codeEditParent->toggleFold(blockNumber);
+            return;
         }
 
         block = block.next();
-        top = bottom;
-        bottom = top + (int) m_codeEditParent->document()->documentLayout()->blockBoundingRect(block).height();
         ++blockNumber;
     }
 }
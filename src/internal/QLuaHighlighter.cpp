@@ -1,41 +1,86 @@
 // QCodeEditor
 #include <QLuaHighlighter>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
 #include <QSyntaxStyle>
-#include <QLanguage>
+#include <QHighlightRule>
+#include <QCharacterSet>
+#include <QHighlightBlockRule>
+#include <QKeywordMatcher>
+#include <QLanguageTable>
 
 // Qt
-#include <QFile>
+#include <QRegularExpression>
+#include <QVector>
 
+/**
+ * @brief Class, that describes Lua grammar.
+ */
+class QLuaHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    QKeywordMatcher m_keywordMatcher;
+    QVector<QHighlightRule> m_highlightRules;
+    QVector<QHighlightBlockRule> m_highlightBlockRules;
+
+    QRegularExpression m_requirePattern;
+    QRegularExpression m_functionPattern;
+    QRegularExpression m_defTypePattern;
+
+    int m_preprocessorFormat;
+    int m_stringFormat;
+    int m_typeFormat;
+    int m_functionFormat;
+};
 
 QLuaHighlighter::QLuaHighlighter(QTextDocument* document) :
-    QStyleSyntaxHighlighter(document),
+    QStyleSyntaxHighlighter(document)
+{
+    setGrammar(QSyntaxGrammar::shared(
+        "Lua",
+        []() -> QSyntaxGrammar* { return new Grammar(); }
+    ));
+}
+
+QLuaHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_keywordMatcher(),
     m_highlightRules(),
     m_highlightBlockRules(),
     m_requirePattern(QRegularExpression(R"(require\s*([("'][a-zA-Z0-9*._]+['")]))")),
     m_functionPattern(QRegularExpression(R"(\b([A-Za-z0-9_]+(?:\s+|::))*([A-Za-z0-9_]+)(?=\())")),
-    m_defTypePattern(QRegularExpression(R"(\b([A-Za-z0-9_]+)\s+[A-Za-z]{1}[A-Za-z0-9_]+\s*[=])"))
+    m_defTypePattern(QRegularExpression(R"(\b([A-Za-z0-9_]+)\s+[A-Za-z]{1}[A-Za-z0-9_]+\s*[=])")),
+    m_preprocessorFormat(QSyntaxStyle::formatId("Preprocessor")),
+    m_stringFormat(QSyntaxStyle::formatId("String")),
+    m_typeFormat(QSyntaxStyle::formatId("Type")),
+    m_functionFormat(QSyntaxStyle::formatId("Function"))
 {
-    Q_INIT_RESOURCE(qcodeeditor_resources);
-    QFile fl(":/languages/lua.xml");
-
-    if (!fl.open(QIODevice::ReadOnly))
-    {
-        return;
-    }
-
-    QLanguage language(&fl);
+    auto language = QLanguageTable::find("lua");
 
-    if (!language.isLoaded())
+    if (language == nullptr)
     {
         return;
     }
 
-    auto keys = language.keys();
+    auto keys = language->keys();
     for (auto&& key : keys)
     {
-        auto names = language.names(key);
+        auto names = language->names(key);
         for (auto&& name : names)
         {
+            if (QKeywordMatcher::isIdentifier(name))
+            {
+                m_keywordMatcher.insert(name, QSyntaxStyle::formatId(key));
+                continue;
+            }
+
             m_highlightRules.append({
                 QRegularExpression(QString(R"(\b\s{0,1}%1\s{0,1}\b)").arg(name)),
                 key
@@ -82,7 +127,7 @@ QLuaHighlighter::QLuaHighlighter(QTextDocument* document) :
      });
 }
 
-void QLuaHighlighter::highlightBlock(const QString& text)
+void QLuaHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
 {
     { // Checking for require
         auto matchIterator = m_requirePattern.globalMatch(text);
@@ -91,16 +136,16 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Preprocessor")
+                m_preprocessorFormat
             );
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("String")
+                m_stringFormat
             );
         }
     }
@@ -111,16 +156,16 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                m_typeFormat
             );
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                m_functionFormat
             );
         }
     }
@@ -131,36 +176,39 @@ void QLuaHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(1),
                 match.capturedLength(1),
-                syntaxStyle()->getFormat("Type")
+                m_typeFormat
             );
         }
     }
 
-    for (auto& rule : m_highlightRules)
+    m_keywordMatcher.match(text, [&context](int start, int length, int formatId)
     {
-        auto matchIterator = rule.pattern.globalMatch(text);
+        context.setFormat(start, length, formatId);
+    });
 
-        while (matchIterator.hasNext())
-        {
-            auto match = matchIterator.next();
+    auto characters = QCharacterSet::fromText(text);
 
-            setFormat(
-                match.capturedStart(),
-                match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
-            );
+    for (auto& rule : m_highlightRules)
+    {
+        if (!rule.firstCharacters.intersects(characters))
+        {
+            continue;
         }
+
+        rule.apply(text, context);
     }
 
-    setCurrentBlockState(0);
+    context.setCurrentBlockState(0);
     int startIndex = 0;
-    int highlightRuleId = previousBlockState();
+    int highlightRuleId = context.previousBlockState();
     if (highlightRuleId < 1 || highlightRuleId > m_highlightBlockRules.size()) {
         for(int i = 0; i < m_highlightBlockRules.size(); ++i) {
+            context.beginRule(m_highlightBlockRules.at(i).startPattern);
             startIndex = text.indexOf(m_highlightBlockRules.at(i).startPattern);
+            context.endRule(startIndex >= 0 ? 1 : 0);
             if (startIndex >= 0) {
                 highlightRuleId = i + 1;
                 break;
@@ -171,14 +219,19 @@ void QLuaHighlighter::highlightBlock(const QString& text)
     while (startIndex >= 0)
     {
         const auto &blockRules = m_highlightBlockRules.at(highlightRuleId - 1);
+
+        context.beginEndRule(blockRules.endPattern);
+
         auto match = blockRules.endPattern.match(text, startIndex);
 
         int endIndex = match.capturedStart();
         int matchLength = 0;
 
+        context.endRule(endIndex >= 0 ? 1 : 0);
+
         if (endIndex == -1)
         {
-            setCurrentBlockState(highlightRuleId);
+            context.setCurrentBlockState(highlightRuleId);
             matchLength = text.length() - startIndex;
         }
         else
@@ -186,11 +239,14 @@ void QLuaHighlighter::highlightBlock(const QString& text)
             matchLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        context.setFormat(
             startIndex,
             matchLength,
-            syntaxStyle()->getFormat(blockRules.formatName)
+            blockRules.formatId
         );
+
+        context.beginRule(blockRules.startPattern);
         startIndex = text.indexOf(blockRules.startPattern, startIndex + matchLength);
+        context.endRule(startIndex >= 0 ? 1 : 0);
     }
 }
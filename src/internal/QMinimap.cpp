@@ -0,0 +1,283 @@
+// QCodeEditor
+#include <QMinimap>
+#include <QSyntaxStyle>
+#include <QCodeEditor>
+
+// Qt
+#include <QAbstractTextDocumentLayout>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QVarLengthArray>
+
+// std
+#include <algorithm>
+#include <limits>
+
+// Every block is a row of 2 pixels, character
+// is 1 pixel and rows are separated by 1 pixel.
+static const int minimapWidth = 100;
+static const int lineHeight = 2;
+static const int tabWidth = 4;
+
+// Number of blocks, rendered into one tile
+static const int tileBlocks = 128;
+static const int tileHeight = tileBlocks * lineHeight;
+
+// Cache size in kilobytes, enough for a few
+// screens of tiles
+static const int cacheKilobytes = 16 * 1024;
+
+QMinimap::QMinimap(QCodeEditor* parent) :
+    QWidget(parent),
+    m_syntaxStyle(nullptr),
+    m_codeEditParent(parent),
+    m_backgroundColor(),
+    m_textColor(),
+    m_viewportColor(),
+    m_tiles(cacheKilobytes),
+    m_blockCount(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setCursor(Qt::ArrowCursor);
+}
+
+QSize QMinimap::sizeHint() const
+{
+    return {minimapWidth, 0};
+}
+
+void QMinimap::setSyntaxStyle(QSyntaxStyle* style)
+{
+    m_syntaxStyle = style;
+
+    if (m_syntaxStyle)
+    {
+        m_backgroundColor = m_syntaxStyle->getFormat("Text").background().color();
+        m_textColor       = m_syntaxStyle->getFormat("Text").foreground().color();
+        m_viewportColor   = m_syntaxStyle->getFormat("Selection").background().color();
+        m_viewportColor.setAlpha(96);
+    }
+
+    invalidateAll();
+}
+
+QSyntaxStyle* QMinimap::syntaxStyle() const
+{
+    return m_syntaxStyle;
+}
+
+void QMinimap::invalidateBlocks(int first, int last)
+{
+    auto blockCount = m_codeEditParent->document()->blockCount();
+
+    auto firstTile = first / tileBlocks;
+    auto lastTile = last / tileBlocks;
+
+    // Blocks after inserted or removed ones are shifted
+    if (blockCount != m_blockCount)
+    {
+        lastTile = std::numeric_limits<int>::max();
+        m_blockCount = blockCount;
+    }
+
+    if (firstTile == lastTile)
+    {
+        m_tiles.remove(firstTile);
+    }
+    else
+    {
+        for (auto tile : m_tiles.keys())
+        {
+            if (tile >= firstTile && tile <= lastTile)
+            {
+                m_tiles.remove(tile);
+            }
+        }
+    }
+
+    update();
+}
+
+void QMinimap::invalidateAll()
+{
+    m_tiles.clear();
+    update();
+}
+
+int QMinimap::scrollOffset() const
+{
+    auto contentHeight = m_codeEditParent->document()->blockCount() * lineHeight;
+
+    if (contentHeight <= height())
+    {
+        return 0;
+    }
+
+    auto scrollBar = m_codeEditParent->verticalScrollBar();
+
+    if (scrollBar->maximum() <= scrollBar->minimum())
+    {
+        return 0;
+    }
+
+    auto fraction = double(scrollBar->value() - scrollBar->minimum()) /
+                    (scrollBar->maximum() - scrollBar->minimum());
+
+    return static_cast<int>(fraction * (contentHeight - height()));
+}
+
+QImage QMinimap::renderTile(int tile) const
+{
+    QImage image(minimapWidth, tileHeight, QImage::Format_ARGB32_Premultiplied);
+    image.fill(m_backgroundColor);
+
+    auto textColor = m_textColor.rgba();
+    QVarLengthArray<QRgb, minimapWidth> colors;
+
+    auto block = m_codeEditParent->document()->findBlockByNumber(tile * tileBlocks);
+
+    for (int row = 0;
+         row < tileBlocks && block.isValid();
+         ++row, block = block.next())
+    {
+        auto text = block.text();
+
+        // Column is never less than position, so
+        // characters after last column are skipped
+        auto length = qMin(text.size(), minimapWidth);
+
+        colors.resize(length);
+        std::fill(colors.begin(), colors.end(), textColor);
+
+        // Formats, that highlighter has already set
+        for (auto&& range : block.layout()->formats())
+        {
+            if (range.format.foreground().style() == Qt::NoBrush)
+            {
+                continue;
+            }
+
+            auto color = range.format.foreground().color().rgba();
+            auto end = qMin(range.start + range.length, length);
+
+            for (int i = qMax(0, range.start); i < end; ++i)
+            {
+                colors[i] = color;
+            }
+        }
+
+        auto line = reinterpret_cast<QRgb*>(image.scanLine(row * lineHeight));
+
+        int column = 0;
+        for (int i = 0; i < length && column < minimapWidth; ++i)
+        {
+            auto character = text[i];
+
+            if (character == '\t')
+            {
+                column += tabWidth - column % tabWidth;
+                continue;
+            }
+
+            if (!character.isSpace())
+            {
+                line[column] = colors[i];
+            }
+
+            ++column;
+        }
+    }
+
+    return image;
+}
+
+void QMinimap::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+
+    painter.fillRect(event->rect(), m_backgroundColor);
+
+    auto offset = scrollOffset();
+
+    auto firstTile = (offset + event->rect().top()) / tileHeight;
+    auto lastTile = (offset + event->rect().bottom()) / tileHeight;
+    auto tileCount = (m_codeEditParent->document()->blockCount() + tileBlocks - 1) / tileBlocks;
+
+    for (int tile = firstTile; tile <= lastTile && tile < tileCount; ++tile)
+    {
+        auto image = m_tiles.object(tile);
+
+        if (image == nullptr)
+        {
+            image = new QImage(renderTile(tile));
+            m_tiles.insert(tile, image, image->bytesPerLine() * image->height() / 1024);
+        }
+
+        painter.drawImage(0, tile * tileHeight - offset, *image);
+    }
+
+    // Visible part of document
+    auto first = m_codeEditParent->getFirstVisibleBlock();
+    auto last = m_codeEditParent->cursorForPosition(
+        m_codeEditParent->viewport()->rect().bottomLeft()
+    ).blockNumber();
+
+    painter.fillRect(
+        QRect(0,
+              first * lineHeight - offset,
+              width(),
+              (last - first + 1) * lineHeight
+        ),
+        m_viewportColor
+    );
+}
+
+void QMinimap::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton)
+    {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    scrollTo(event->pos().y());
+}
+
+void QMinimap::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!(event->buttons() & Qt::LeftButton))
+    {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+
+    scrollTo(event->pos().y());
+}
+
+void QMinimap::scrollTo(int y)
+{
+    auto document = m_codeEditParent->document();
+
+    auto blockNumber = qBound(
+        0,
+        (y + scrollOffset()) / lineHeight,
+        document->blockCount() - 1
+    );
+
+    // Folded blocks have no position in editor
+    auto block = document->findBlockByNumber(blockNumber);
+    while (!block.isVisible() && block.previous().isValid())
+    {
+        block = block.previous();
+    }
+
+    auto rect = document->documentLayout()->blockBoundingRect(block);
+
+    m_codeEditParent->verticalScrollBar()->setValue(
+        static_cast<int>(rect.top()) - m_codeEditParent->viewport()->height() / 2
+    );
+}
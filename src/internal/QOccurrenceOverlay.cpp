@@ -0,0 +1,555 @@
+// QCodeEditor
+#include <QOccurrenceOverlay>
+#include <QSyntaxStyle>
+
+// Qt
+#include <QTextEdit>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QPainter>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QTimer>
+
+// Number of blocks before and after painted
+// area, that are searched too.
+static const int searchBlocksMargin = 64;
+
+// Number of blocks, copied at once, when
+// document is copied from scratch
+static const int snapshotBlocks = 1024;
+
+// Delay of counting after last change, so
+// typing doesn't start counting on every key
+static const int countDelayMilliseconds = 100;
+
+/**
+ * @brief Static function for counting case
+ * insensitive occurrences of text in block.
+ */
+static int countInBlock(const QString& block, const QString& text)
+{
+    if (text.isEmpty())
+    {
+        return 0;
+    }
+
+    int count = 0;
+
+    auto index = block.indexOf(text, 0, Qt::CaseInsensitive);
+    while (index >= 0)
+    {
+        ++count;
+        index = block.indexOf(text, index + text.size(), Qt::CaseInsensitive);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Class, that describes background job.
+ * It applies queued updates to copy of document,
+ * until queue is empty, and reports count.
+ */
+class QOccurrenceOverlay::CountJob : public QRunnable
+{
+public:
+
+    explicit CountJob(QOccurrenceOverlay* overlay) :
+        QRunnable(),
+        m_overlay(overlay)
+    {}
+
+    // Disable copying
+    CountJob(const CountJob&) = delete;
+    CountJob& operator=(const CountJob&) = delete;
+
+    void run() override
+    {
+        while (true)
+        {
+            QVector<Update> updates;
+
+            {
+                QMutexLocker locker(&m_overlay->m_mutex);
+
+                if (m_overlay->m_updates.isEmpty())
+                {
+                    m_overlay->m_jobRunning = false;
+                    return;
+                }
+
+                updates.swap(m_overlay->m_updates);
+            }
+
+            auto generation = m_overlay->m_countGeneration.loadAcquire();
+
+            const Update* last = nullptr;
+
+            for (auto&& update : updates)
+            {
+                // Updates of previous document are dropped,
+                // new document starts with replacing all blocks
+                if (update.generation == generation)
+                {
+                    m_overlay->applyUpdate(update);
+                    last = &update;
+                }
+            }
+
+            if (last == nullptr ||
+                !m_overlay->countOccurrences(generation, last->textRevision))
+            {
+                continue;
+            }
+
+            auto overlay = m_overlay;
+            auto sequence = last->sequence;
+            auto count = m_overlay->m_count;
+
+            QMetaObject::invokeMethod(
+                overlay,
+                [overlay, generation, sequence, count]()
+                { overlay->applyCount(generation, sequence, count); },
+                Qt::QueuedConnection
+            );
+        }
+    }
+
+private:
+
+    QOccurrenceOverlay* m_overlay;
+};
+
+QOccurrenceOverlay::QOccurrenceOverlay(QTextEdit* editor) :
+    QObject(editor),
+    m_editor(editor),
+    m_style(nullptr),
+    m_document(),
+    m_documentConnection(),
+    m_text(),
+    m_occurrences(),
+    m_firstBlock(0),
+    m_lastBlock(-1),
+    m_totalCount(0),
+    m_threadPool(),
+    m_countGeneration(0),
+    m_textRevision(0),
+    m_jobTimer(),
+    m_copying(false),
+    m_blockCount(0),
+    m_copiedBlocks(0),
+    m_snapshotScheduled(false),
+    m_sequence(0),
+    m_mutex(),
+    m_updates(),
+    m_jobRunning(false),
+    m_blockTexts(),
+    m_blockCounts(),
+    m_countedText(),
+    m_countsValid(true),
+    m_count(0)
+{
+    m_threadPool.setMaxThreadCount(1);
+
+    m_jobTimer.setSingleShot(true);
+    m_jobTimer.setInterval(countDelayMilliseconds);
+
+    connect(
+        &m_jobTimer,
+        &QTimer::timeout,
+        this,
+        &QOccurrenceOverlay::startJob
+    );
+
+    trackDocument();
+}
+
+QOccurrenceOverlay::~QOccurrenceOverlay()
+{
+    m_countGeneration.fetchAndAddOrdered(1);
+    m_threadPool.waitForDone();
+}
+
+void QOccurrenceOverlay::setText(const QString& text)
+{
+    if (m_text == text)
+    {
+        return;
+    }
+
+    m_text = text;
+
+    trackDocument();
+
+    // Document is copied to background thread only,
+    // when something is searched in it
+    if (!m_copying)
+    {
+        if (!m_text.isEmpty())
+        {
+            startCopy();
+        }
+    }
+    else
+    {
+        // Copied blocks are counted again for new text
+        m_textRevision.fetchAndAddOrdered(1);
+        enqueue(0, -1, 0);
+    }
+
+    invalidate();
+}
+
+QString QOccurrenceOverlay::text() const
+{
+    return m_text;
+}
+
+int QOccurrenceOverlay::totalCount() const
+{
+    return m_totalCount;
+}
+
+void QOccurrenceOverlay::setSyntaxStyle(QSyntaxStyle* style)
+{
+    m_style = style;
+
+    m_editor->viewport()->update();
+}
+
+void QOccurrenceOverlay::paint(QPainter& painter, const QRect& rect)
+{
+    if (m_text.isEmpty() ||
+        m_style == nullptr)
+    {
+        return;
+    }
+
+    trackDocument();
+
+    auto firstBlock = m_editor->cursorForPosition(rect.topLeft()).blockNumber();
+    auto lastBlock = m_editor->cursorForPosition(rect.bottomLeft()).blockNumber();
+
+    if (firstBlock < m_firstBlock ||
+        lastBlock > m_lastBlock)
+    {
+        searchOccurrences(
+            qMax(0, firstBlock - searchBlocksMargin),
+            lastBlock + searchBlocksMargin
+        );
+    }
+
+    painter.save();
+    painter.setPen(m_style->getFormat("Occurrences").background().color());
+    painter.setBrush(Qt::NoBrush);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QTextCursor cursor(m_editor->document());
+
+    for (auto&& occurrence : m_occurrences)
+    {
+        cursor.setPosition(occurrence.position);
+        auto start = m_editor->cursorRect(cursor);
+
+        cursor.setPosition(occurrence.position + occurrence.length);
+        auto end = m_editor->cursorRect(cursor);
+
+        // Wrapped occurrence is framed till line end
+        auto right = start.top() == end.top() ?
+                     end.left()
+                     :
+                     m_editor->viewport()->width();
+
+        QRectF frame(start.left(), start.top(), right - start.left(), start.height());
+
+        if (!frame.intersects(rect))
+        {
+            continue;
+        }
+
+        painter.drawRoundedRect(frame.adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
+    }
+
+    painter.restore();
+}
+
+void QOccurrenceOverlay::trackDocument()
+{
+    if (m_document == m_editor->document())
+    {
+        return;
+    }
+
+    disconnect(m_documentConnection);
+
+    m_document = m_editor->document();
+    m_countGeneration.fetchAndAddOrdered(1);
+
+    m_documentConnection = connect(
+        m_document,
+        &QTextDocument::contentsChange,
+        this,
+        [this](int position, int charsRemoved, int charsAdded)
+        {
+            if (m_copying)
+            {
+                auto blockCount = m_document->blockCount();
+                auto last = blockCount - 1;
+                auto first = m_document->findBlock(position).blockNumber();
+                auto end = m_document->findBlock(position + charsAdded).blockNumber();
+
+                first = first < 0 ? last : first;
+                end = end < 0 ? last : end;
+
+                // Changed blocks replace the same blocks,
+                // and inserted or removed blocks
+                auto removed = end - first + 1 - (blockCount - m_blockCount);
+                m_blockCount = blockCount;
+
+                // Blocks, that were not copied yet, are
+                // copied by snapshot with new text
+                if (first < m_copiedBlocks)
+                {
+                    auto copiedAfter = qMax(0, m_copiedBlocks - first - removed);
+
+                    enqueue(first, end, qMin(removed, m_copiedBlocks - first));
+                    m_copiedBlocks = end + 1 + copiedAfter;
+                }
+            }
+
+            if (!m_text.isEmpty() &&
+                (charsRemoved || charsAdded))
+            {
+                invalidate();
+            }
+        }
+    );
+
+    // Occurrences of previous document are dropped.
+    // Viewport isn't updated, because it's called
+    // from painting too.
+    m_occurrences.clear();
+    m_firstBlock = 0;
+    m_lastBlock = -1;
+
+    m_totalCount = m_text.isEmpty() ? 0 : -1;
+
+    m_copying = false;
+    m_blockCount = 0;
+    m_copiedBlocks = 0;
+
+    if (!m_text.isEmpty())
+    {
+        startCopy();
+    }
+}
+
+void QOccurrenceOverlay::searchOccurrences(int firstBlock, int lastBlock)
+{
+    m_occurrences.clear();
+    m_firstBlock = firstBlock;
+    m_lastBlock = lastBlock;
+
+    auto block = m_editor->document()->findBlockByNumber(firstBlock);
+    for (auto number = firstBlock;
+         block.isValid() && number <= lastBlock;
+         block = block.next(), ++number)
+    {
+        auto text = block.text();
+
+        auto index = text.indexOf(m_text, 0, Qt::CaseInsensitive);
+        while (index >= 0)
+        {
+            m_occurrences.append({block.position() + index, m_text.size()});
+
+            index = text.indexOf(m_text, index + m_text.size(), Qt::CaseInsensitive);
+        }
+    }
+}
+
+void QOccurrenceOverlay::invalidate()
+{
+    m_occurrences.clear();
+    m_firstBlock = 0;
+    m_lastBlock = -1;
+
+    // Count is reported by background thread,
+    // after changed blocks are sent to it
+    m_totalCount = m_text.isEmpty() ? 0 : -1;
+
+    m_editor->viewport()->update();
+}
+
+void QOccurrenceOverlay::startCopy()
+{
+    m_copying = true;
+
+    // Previous copy is dropped by background thread
+    m_blockCount = m_document->blockCount();
+    m_copiedBlocks = 0;
+    enqueue(0, -1, -1);
+
+    scheduleSnapshot();
+}
+
+void QOccurrenceOverlay::enqueue(int first, int last, int removed)
+{
+    Update update {
+        m_countGeneration.loadAcquire(),
+        ++m_sequence,
+        first,
+        removed,
+        {},
+        m_text,
+        m_textRevision.loadAcquire()
+    };
+
+    auto block = m_document->findBlockByNumber(first);
+    for (auto number = first;
+         block.isValid() && number <= last;
+         block = block.next(), ++number)
+    {
+        update.texts.append(block.text());
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_updates.append(std::move(update));
+    }
+
+    // Counting once after series of changes
+    m_jobTimer.start();
+}
+
+void QOccurrenceOverlay::scheduleSnapshot()
+{
+    if (m_snapshotScheduled)
+    {
+        return;
+    }
+
+    m_snapshotScheduled = true;
+    QTimer::singleShot(0, this, &QOccurrenceOverlay::processSnapshot);
+}
+
+void QOccurrenceOverlay::processSnapshot()
+{
+    m_snapshotScheduled = false;
+
+    if (!m_copying ||
+        m_copiedBlocks >= m_blockCount)
+    {
+        return;
+    }
+
+    auto last = qMin(m_copiedBlocks + snapshotBlocks, m_blockCount) - 1;
+
+    enqueue(m_copiedBlocks, last, 0);
+    m_copiedBlocks = last + 1;
+
+    scheduleSnapshot();
+}
+
+void QOccurrenceOverlay::startJob()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_jobRunning ||
+        m_updates.isEmpty())
+    {
+        return;
+    }
+
+    m_jobRunning = true;
+    m_threadPool.start(new CountJob(this));
+}
+
+void QOccurrenceOverlay::applyUpdate(const Update& update)
+{
+    if (update.removed < 0)
+    {
+        m_blockTexts.clear();
+        m_blockCounts.clear();
+        m_count = 0;
+    }
+
+    // Copied blocks are counted again,
+    // after all updates are applied
+    if (update.text != m_countedText)
+    {
+        m_countedText = update.text;
+        m_countsValid = false;
+    }
+
+    auto first = qMin(update.first, m_blockTexts.size());
+    auto removed = qBound(0, update.removed, m_blockTexts.size() - first);
+
+    for (int i = first; i < first + removed; ++i)
+    {
+        m_count -= m_blockCounts[i];
+    }
+
+    m_blockTexts.remove(first, removed);
+    m_blockTexts.insert(first, update.texts.size(), QString());
+    m_blockCounts.remove(first, removed);
+    m_blockCounts.insert(first, update.texts.size(), 0);
+
+    for (int i = 0; i < update.texts.size(); ++i)
+    {
+        m_blockTexts[first + i] = update.texts[i];
+
+        if (m_countsValid)
+        {
+            m_blockCounts[first + i] = countInBlock(update.texts[i], m_countedText);
+            m_count += m_blockCounts[first + i];
+        }
+    }
+}
+
+bool QOccurrenceOverlay::countOccurrences(int generation, int textRevision)
+{
+    if (m_countsValid)
+    {
+        return true;
+    }
+
+    m_count = 0;
+
+    for (int i = 0; i < m_blockTexts.size(); ++i)
+    {
+        // Text or document was changed, new
+        // text is counted with next updates
+        if (m_textRevision.loadAcquire() != textRevision ||
+            m_countGeneration.loadAcquire() != generation)
+        {
+            return false;
+        }
+
+        m_blockCounts[i] = countInBlock(m_blockTexts[i], m_countedText);
+        m_count += m_blockCounts[i];
+    }
+
+    m_countsValid = true;
+
+    return true;
+}
+
+void QOccurrenceOverlay::applyCount(int generation, int sequence, int count)
+{
+    // Document was changed, or changes weren't
+    // counted yet, or some blocks weren't copied yet
+    if (generation != m_countGeneration.loadAcquire() ||
+        sequence != m_sequence ||
+        m_copiedBlocks < m_blockCount ||
+        m_text.isEmpty())
+    {
+        return;
+    }
+
+    m_totalCount = count;
+
+    emit totalCountChanged(m_totalCount);
+}
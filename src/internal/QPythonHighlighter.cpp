@@ -1,41 +1,83 @@
 // QCodeEditor
 #include <QPythonHighlighter>
-#include <QLanguage>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
 #include <QSyntaxStyle>
+#include <QHighlightRule>
+#include <QCharacterSet>
+#include <QHighlightBlockRule>
+#include <QKeywordMatcher>
+#include <QLanguageTable>
 
 // Qt
-#include <QFile>
+#include <QRegularExpression>
+#include <QVector>
 #include <QDebug>
 
+/**
+ * @brief Class, that describes Python grammar.
+ */
+class QPythonHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    QKeywordMatcher m_keywordMatcher;
+    QVector<QHighlightRule> m_highlightRules;
+    QVector<QHighlightBlockRule> m_highlightBlockRules;
+
+    QRegularExpression m_includePattern;
+    QRegularExpression m_functionPattern;
+    QRegularExpression m_defTypePattern;
+
+    int m_typeFormat;
+    int m_functionFormat;
+};
+
 QPythonHighlighter::QPythonHighlighter(QTextDocument* document) :
-    QStyleSyntaxHighlighter(document),
+    QStyleSyntaxHighlighter(document)
+{
+    setGrammar(QSyntaxGrammar::shared(
+        "Python",
+        []() -> QSyntaxGrammar* { return new Grammar(); }
+    ));
+}
+
+QPythonHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_keywordMatcher(),
     m_highlightRules     (),
     m_highlightBlockRules(),
     m_includePattern     (QRegularExpression(R"(import \w+)")),
     m_functionPattern    (QRegularExpression(R"(\b([A-Za-z0-9_]+(?:\.))*([A-Za-z0-9_]+)(?=\())")),
-    m_defTypePattern     (QRegularExpression(R"(\b([A-Za-z0-9_]+)\s+[A-Za-z]{1}[A-Za-z0-9_]+\s*[;=])"))
+    m_defTypePattern     (QRegularExpression(R"(\b([A-Za-z0-9_]+)\s+[A-Za-z]{1}[A-Za-z0-9_]+\s*[;=])")),
+    m_typeFormat(QSyntaxStyle::formatId("Type")),
+    m_functionFormat(QSyntaxStyle::formatId("Function"))
 {
-    Q_INIT_RESOURCE(qcodeeditor_resources);
-    QFile fl(":/languages/python.xml");
-
-    if (!fl.open(QIODevice::ReadOnly))
-    {
-        return;
-    }
+    auto language = QLanguageTable::find("python");
 
-    QLanguage language(&fl);
-
-    if (!language.isLoaded())
+    if (language == nullptr)
     {
         return;
     }
 
-    auto keys = language.keys();
+    auto keys = language->keys();
     for (auto&& key : keys)
     {
-        auto names = language.names(key);
+        auto names = language->names(key);
         for (auto&& name : names)
         {
+            if (QKeywordMatcher::isIdentifier(name))
+            {
+                m_keywordMatcher.insert(name, QSyntaxStyle::formatId(key));
+                continue;
+            }
+
             m_highlightRules.append({
                 QRegularExpression(QString(R"(\b%1\b)").arg(name)),
                 key
@@ -81,7 +123,7 @@ QPythonHighlighter::QPythonHighlighter(QTextDocument* document) :
      });
 }
 
-void QPythonHighlighter::highlightBlock(const QString& text)
+void QPythonHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
 {
     // Checking for function
     {
@@ -91,42 +133,45 @@ void QPythonHighlighter::highlightBlock(const QString& text)
         {
             auto match = matchIterator.next();
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(),
                 match.capturedLength(),
-                syntaxStyle()->getFormat("Type")
+                m_typeFormat
             );
 
-            setFormat(
+            context.setFormat(
                 match.capturedStart(2),
                 match.capturedLength(2),
-                syntaxStyle()->getFormat("Function")
+                m_functionFormat
             );
         }
     }
 
-    for (auto& rule : m_highlightRules)
+    m_keywordMatcher.match(text, [&context](int start, int length, int formatId)
     {
-        auto matchIterator = rule.pattern.globalMatch(text);
+        context.setFormat(start, length, formatId);
+    });
 
-        while (matchIterator.hasNext())
-        {
-            auto match = matchIterator.next();
+    auto characters = QCharacterSet::fromText(text);
 
-            setFormat(
-                match.capturedStart(),
-                match.capturedLength(),
-                syntaxStyle()->getFormat(rule.formatName)
-            );
+    for (auto& rule : m_highlightRules)
+    {
+        if (!rule.firstCharacters.intersects(characters))
+        {
+            continue;
         }
+
+        rule.apply(text, context);
     }
 
-    setCurrentBlockState(0);
+    context.setCurrentBlockState(0);
     int startIndex = 0;
-    int highlightRuleId = previousBlockState();
+    int highlightRuleId = context.previousBlockState();
     if (highlightRuleId < 1 || highlightRuleId > m_highlightBlockRules.size()) {
         for(int i = 0; i < m_highlightBlockRules.size(); ++i) {
+            context.beginRule(m_highlightBlockRules.at(i).startPattern);
             startIndex = text.indexOf(m_highlightBlockRules.at(i).startPattern);
+            context.endRule(startIndex >= 0 ? 1 : 0);
 
             if (startIndex >= 0) {
                 highlightRuleId = i + 1;
@@ -138,14 +183,19 @@ void QPythonHighlighter::highlightBlock(const QString& text)
     while (startIndex >= 0)
     {
         const auto &blockRules = m_highlightBlockRules.at(highlightRuleId - 1);
+
+        context.beginEndRule(blockRules.endPattern);
+
         auto match = blockRules.endPattern.match(text, startIndex+1); // Should be + length of start pattern
 
         int endIndex = match.capturedStart();
         int matchLength = 0;
 
+        context.endRule(endIndex >= 0 ? 1 : 0);
+
         if (endIndex == -1)
         {
-            setCurrentBlockState(highlightRuleId);
+            context.setCurrentBlockState(highlightRuleId);
             matchLength = text.length() - startIndex;
         }
         else
@@ -153,11 +203,14 @@ void QPythonHighlighter::highlightBlock(const QString& text)
             matchLength = endIndex - startIndex + match.capturedLength();
         }
 
-        setFormat(
+        context.setFormat(
             startIndex,
             matchLength,
-            syntaxStyle()->getFormat(blockRules.formatName)
+            blockRules.formatId
         );
+
+        context.beginRule(blockRules.startPattern);
         startIndex = text.indexOf(blockRules.startPattern, startIndex + matchLength);
+        context.endRule(startIndex >= 0 ? 1 : 0);
     }
 }
@@ -1,11 +1,269 @@
 // QCodeEditor
 #include <QStyleSyntaxHighlighter>
+#include <QBracketSummary>
+#include <QSyntaxStyle>
+#include <QSyntaxGrammar>
 
-QStyleSyntaxHighlighter::QStyleSyntaxHighlighter(QTextDocument* document) : 
-    QSyntaxHighlighter(document),
-    m_syntaxStyle(nullptr)
+// Qt
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QStringList>
+#include <QJsonDocument>
+#include <QDebug>
+
+// Number of blocks after last pending block, that background
+// job highlights while waiting for block state to converge.
+static const int jobConvergenceBlocks = 1024;
+
+// Limits of single batch of results, sent to GUI thread.
+static const int batchBlocks = 512;
+static const int batchMilliseconds = 16;
+
+// Number of blocks before and after visible range,
+// that are highlighted immediately too.
+static const int visibleBlocksMargin = 64;
+
+// Duration of single idle time slice in lazy mode.
+static const int idleSliceMilliseconds = 8;
+
+// Environment variable, that enables instrumentation
+// of every highlighter.
+static const char* statisticsVariable = "QCODEEDITOR_HIGHLIGHT_STATISTICS";
+
+/**
+ * @brief Class, that describes background job. It highlights
+ * snapshot of document blocks and sends results to GUI thread
+ * in batches.
+ */
+class QStyleSyntaxHighlighter::Job : public QRunnable
+{
+public:
+
+    Job(QStyleSyntaxHighlighter* highlighter,
+        QSharedPointer<const QSyntaxGrammar> grammar,
+        int generation,
+        int revision,
+        int firstBlock,
+        int previousBlockState,
+        QStringList texts,
+        QVector<int> states,
+        int lastPending,
+        bool instrumented) :
+        QRunnable(),
+        m_highlighter(highlighter),
+        m_grammar(std::move(grammar)),
+        m_generation(generation),
+        m_revision(revision),
+        m_firstBlock(firstBlock),
+        m_previousBlockState(previousBlockState),
+        m_texts(std::move(texts)),
+        m_states(std::move(states)),
+        m_lastPending(lastPending),
+        m_instrumented(instrumented)
+    {}
+
+    // Disable copying
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    void run() override
+    {
+        QVector<BlockResult> results;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        auto state = m_previousBlockState;
+
+        for (int i = 0; i < m_texts.size(); ++i)
+        {
+            if (isCancelled())
+            {
+                return;
+            }
+
+            QHighlightContext context(state);
+            context.setInstrumented(m_instrumented);
+
+            QElapsedTimer blockTimer;
+            if (m_instrumented)
+            {
+                blockTimer.start();
+            }
+
+            m_grammar->highlightBlock(m_texts.at(i), context);
+            state = context.currentBlockState();
+
+            // Blocks after last pending one are highlighted
+            // only because state of previous block was changed
+            results.append({
+                m_firstBlock + i,
+                context,
+                m_instrumented ? blockTimer.nsecsElapsed() : 0,
+                i > m_lastPending
+            });
+
+            // Blocks after last pending one are already highlighted,
+            // so there is no need to continue when state is the same.
+            auto finished = (i >= m_lastPending && state == m_states.at(i)) ||
+                            i + 1 == m_texts.size();
+
+            if (finished ||
+                results.size() >= batchBlocks ||
+                timer.elapsed() >= batchMilliseconds)
+            {
+                post(results, finished);
+                results.clear();
+                timer.restart();
+            }
+
+            if (finished)
+            {
+                return;
+            }
+        }
+
+        post(results, true);
+    }
+
+private:
+
+    bool isCancelled() const
+    {
+        return m_highlighter->m_jobGeneration.loadAcquire() != m_generation;
+    }
+
+    void post(const QVector<BlockResult>& results, bool finished)
+    {
+        auto highlighter = m_highlighter;
+        auto generation = m_generation;
+        auto revision = m_revision;
+
+        // Call is dropped if highlighter was destroyed
+        QMetaObject::invokeMethod(
+            highlighter,
+            [highlighter, generation, revision, finished, results]()
+            { highlighter->applyResults(generation, revision, finished, results); },
+            Qt::QueuedConnection
+        );
+    }
+
+    QStyleSyntaxHighlighter* m_highlighter;
+    QSharedPointer<const QSyntaxGrammar> m_grammar;
+    int m_generation;
+    int m_revision;
+    int m_firstBlock;
+    int m_previousBlockState;
+    QStringList m_texts;
+    QVector<int> m_states;
+    int m_lastPending;
+    bool m_instrumented;
+};
+
+QStyleSyntaxHighlighter::QStyleSyntaxHighlighter(QTextDocument* document) :
+    QSyntaxHighlighter(static_cast<QObject*>(document)),
+    m_syntaxStyle(nullptr),
+    m_grammar(),
+    m_highlightMode(HighlightMode::Synchronous),
+    m_firstVisibleBlock(0),
+    m_lastVisibleBlock(-1),
+    m_offscreenFormatting(true),
+    m_trackedDocument(),
+    m_documentConnection(),
+    m_revision(0),
+    m_reformatDetached(false),
+    m_highlightRevision(0),
+    m_tokenArena(),
+    m_threadPool(),
+    m_jobGeneration(0),
+    m_jobScheduled(false),
+    m_jobRunning(false),
+    m_jobFirstBlock(0),
+    m_jobLastBlock(-1),
+    m_results(),
+    m_applyingResults(false),
+    m_idleSliceScheduled(false),
+    m_processingIdleSlice(false),
+    m_idleSliceTimer(),
+    m_firstPendingBlock(0),
+    m_lastPendingBlock(-1),
+    m_blockCount(0),
+    m_restyling(false),
+    m_restyleSliceScheduled(false),
+    m_restyleBlock(-1),
+    m_instrumented(qEnvironmentVariableIntValue(statisticsVariable) != 0),
+    m_statistics(),
+    m_lastHighlightedBlock(-1),
+    m_lastStateChanged(false)
+{
+    m_threadPool.setMaxThreadCount(1);
+
+    // Document is only parent of base class,
+    // so contents change is tracked first
+    setDocument(document);
+}
+
+QStyleSyntaxHighlighter::~QStyleSyntaxHighlighter()
+{
+    cancelJob();
+    m_threadPool.waitForDone();
+
+    clearBlockData();
+
+    if (m_instrumented &&
+        m_statistics.blocks > 0 &&
+        qEnvironmentVariableIntValue(statisticsVariable) != 0)
+    {
+        qInfo().noquote() << QJsonDocument(m_statistics.toJson()).toJson();
+    }
+}
+
+void QStyleSyntaxHighlighter::setDocument(QTextDocument* document)
+{
+    cancelJob();
+    clearBlockData();
+
+    // Contents change of document is handled before
+    // QSyntaxHighlighter highlights changed blocks,
+    // so pending blocks are shifted before changed
+    // blocks are added to them
+    trackDocument(document);
+
+    QSyntaxHighlighter::setDocument(document);
+    m_reformatDetached = false;
+
+    if (m_highlightMode == HighlightMode::Lazy &&
+        document != nullptr)
+    {
+        // Blocks are highlighted, when they are
+        // visible or when event loop is idle
+        detachReformatting();
+        addPendingBlocks(0, document->blockCount() - 1);
+        highlightVisibleBlocks();
+        scheduleIdleSlice();
+    }
+}
+
+void QStyleSyntaxHighlighter::rehighlight()
 {
+    if (!m_reformatDetached ||
+        document() == nullptr)
+    {
+        QSyntaxHighlighter::rehighlight();
+        return;
+    }
+
+    // Blocks, highlighted with previous
+    // revision, are pending
+    ++m_highlightRevision;
 
+    addPendingBlocks(0, document()->blockCount() - 1);
+    highlightVisibleBlocks();
+    scheduleIdleSlice();
 }
 
 void QStyleSyntaxHighlighter::setSyntaxStyle(QSyntaxStyle* style)
@@ -17,3 +275,1011 @@ QSyntaxStyle* QStyleSyntaxHighlighter::syntaxStyle() const
 {
     return m_syntaxStyle;
 }
+
+void QStyleSyntaxHighlighter::setHighlightMode(HighlightMode mode)
+{
+    if (m_highlightMode == mode)
+    {
+        return;
+    }
+
+    m_highlightMode = mode;
+
+    if (m_highlightMode == HighlightMode::Synchronous)
+    {
+        // Pending blocks have to be highlighted right now
+        cancelJob();
+        attachReformatting();
+        rehighlight();
+    }
+    else if (m_highlightMode == HighlightMode::Asynchronous)
+    {
+        if (m_reformatDetached)
+        {
+            attachReformatting();
+            rehighlight();
+        }
+
+        scheduleJob();
+    }
+    else if (document() != nullptr)
+    {
+        cancelJob();
+        detachReformatting();
+
+        // Highlighted blocks are skipped by idle slices
+        addPendingBlocks(0, document()->blockCount() - 1);
+        scheduleIdleSlice();
+    }
+}
+
+void QStyleSyntaxHighlighter::restyle()
+{
+    if (document() == nullptr)
+    {
+        return;
+    }
+
+    if (!m_grammar)
+    {
+        rehighlight();
+        return;
+    }
+
+    trackDocument(document());
+
+    auto number = qMax(0, m_firstVisibleBlock - visibleBlocksMargin);
+    auto block = document()->findBlockByNumber(number);
+    for (;
+         block.isValid() && number <= m_lastVisibleBlock + visibleBlocksMargin;
+         block = block.next(), ++number)
+    {
+        restyleBlock(block);
+    }
+
+    emit blocksRestyled(qMax(0, m_firstVisibleBlock - visibleBlocksMargin), number - 1);
+
+    // Visible blocks are restyled once more, it's
+    // cheaper than tracking them
+    m_restyleBlock = 0;
+    scheduleRestyleSlice();
+}
+
+QStyleSyntaxHighlighter::HighlightMode QStyleSyntaxHighlighter::highlightMode() const
+{
+    return m_highlightMode;
+}
+
+void QStyleSyntaxHighlighter::setVisibleBlocks(int first, int last)
+{
+    m_firstVisibleBlock = first;
+    m_lastVisibleBlock = last;
+
+    highlightVisibleBlocks();
+}
+
+void QStyleSyntaxHighlighter::setOffscreenFormattingEnabled(bool enabled)
+{
+    if (m_offscreenFormatting == enabled)
+    {
+        return;
+    }
+
+    m_offscreenFormatting = enabled;
+
+    // Blocks, that were not formatted, get formats from
+    // their tokens. Synchronous mode formats every block.
+    if (m_offscreenFormatting &&
+        m_grammar &&
+        m_highlightMode != HighlightMode::Synchronous)
+    {
+        restyle();
+    }
+}
+
+bool QStyleSyntaxHighlighter::isOffscreenFormattingEnabled() const
+{
+    return m_offscreenFormatting;
+}
+
+qint64 QStyleSyntaxHighlighter::tokenReservedBytes() const
+{
+    return m_tokenArena ? m_tokenArena->reservedBytes() : 0;
+}
+
+qint64 QStyleSyntaxHighlighter::tokenUsedBytes() const
+{
+    return m_tokenArena ? m_tokenArena->usedBytes() : 0;
+}
+
+QSharedPointer<const QSyntaxGrammar> QStyleSyntaxHighlighter::grammar() const
+{
+    return m_grammar;
+}
+
+void QStyleSyntaxHighlighter::setInstrumentationEnabled(bool enabled)
+{
+    m_instrumented = enabled;
+}
+
+bool QStyleSyntaxHighlighter::isInstrumentationEnabled() const
+{
+    return m_instrumented;
+}
+
+QHighlightStatistics QStyleSyntaxHighlighter::statistics() const
+{
+    return m_statistics;
+}
+
+void QStyleSyntaxHighlighter::resetStatistics()
+{
+    m_statistics = QHighlightStatistics();
+    m_lastHighlightedBlock = -1;
+    m_lastStateChanged = false;
+}
+
+void QStyleSyntaxHighlighter::setGrammar(QSharedPointer<const QSyntaxGrammar> grammar)
+{
+    cancelJob();
+
+    // Brackets and tokens were found by previous grammar
+    if (m_grammar != grammar)
+    {
+        clearBlockData();
+    }
+
+    m_grammar = std::move(grammar);
+}
+
+void QStyleSyntaxHighlighter::highlightBlock(const QString& text)
+{
+    if (!m_grammar)
+    {
+        return;
+    }
+
+    trackDocument(document());
+
+    auto blockNumber = currentBlock().blockNumber();
+
+    auto restyled = m_restyling &&
+                    currentBlockData()->isTokensComplete();
+
+    if (restyled)
+    {
+        applyTokens(*currentBlockData());
+        currentBlockData()->setFormatted(true);
+
+        // State is the same, so following
+        // blocks are not highlighted again
+        setCurrentBlockState(currentBlockState());
+        return;
+    }
+
+    if (m_applyingResults)
+    {
+        auto result = m_results.find(blockNumber);
+
+        if (result != m_results.end())
+        {
+            if (m_instrumented &&
+                result->context.isInstrumented())
+            {
+                addStatistics(
+                    text,
+                    result->context,
+                    result->nanoseconds,
+                    result->cascade
+                );
+            }
+
+            applyContext(text, result->context);
+            setCurrentBlockStatus(QHighlightBlockData::Status::Highlighted);
+
+            m_results.erase(result);
+            return;
+        }
+    }
+
+    // Idle slice highlights blocks in order until time is over
+    auto idle = m_processingIdleSlice &&
+                m_idleSliceTimer.elapsed() < idleSliceMilliseconds;
+
+    if (m_highlightMode == HighlightMode::Synchronous ||
+        isBlockVisible(blockNumber) ||
+        idle)
+    {
+        QHighlightContext context(previousBlockState());
+        context.setInstrumented(m_instrumented);
+
+        QElapsedTimer timer;
+        if (m_instrumented)
+        {
+            timer.start();
+        }
+
+        m_grammar->highlightBlock(text, context);
+
+        if (m_instrumented)
+        {
+            // Already highlighted block is highlighted again
+            // right after block, whose state was changed
+            auto data = QHighlightBlockData::get(currentBlock());
+            auto cascade = data != nullptr &&
+                           data->status() == QHighlightBlockData::Status::Highlighted &&
+                           blockNumber == m_lastHighlightedBlock + 1 &&
+                           m_lastStateChanged;
+
+            addStatistics(text, context, timer.nsecsElapsed(), cascade);
+        }
+
+        applyContext(text, context);
+
+        if (isPreviousBlockPending())
+        {
+            setCurrentBlockStatus(QHighlightBlockData::Status::Outdated);
+
+            if (m_highlightMode != HighlightMode::Synchronous)
+            {
+                addPendingBlocks(blockNumber, blockNumber);
+            }
+        }
+        else
+        {
+            setCurrentBlockStatus(QHighlightBlockData::Status::Highlighted);
+        }
+
+        return;
+    }
+
+    deferCurrentBlock();
+    addPendingBlocks(blockNumber, blockNumber);
+
+    if (m_highlightMode == HighlightMode::Lazy)
+    {
+        scheduleIdleSlice();
+        return;
+    }
+
+    if (!m_jobRunning ||
+        blockNumber < m_jobFirstBlock ||
+        blockNumber > m_jobLastBlock)
+    {
+        scheduleJob();
+    }
+}
+
+void QStyleSyntaxHighlighter::applyContext(const QString& text, const QHighlightContext& context)
+{
+    // Every formatted block is laid out again, so block out
+    // of visible range is formatted, when it becomes visible
+    auto formatted = m_offscreenFormatting ||
+                     m_highlightMode == HighlightMode::Synchronous ||
+                     isBlockVisible(currentBlock().blockNumber()) ||
+                     isCurrentBlockFormatted();
+
+    if (formatted)
+    {
+        applyFormats(context.formats());
+    }
+
+    setCurrentBlockState(context.currentBlockState());
+
+    auto data = currentBlockData();
+    data->setFormatted(formatted);
+    data->setHighlightRevision(m_highlightRevision);
+    data->setTokens(m_tokenArena, context.formats(), text.size());
+
+    // Brackets in strings and comments are skipped
+    // by tokens, unless block has too many of them
+    data->setBracketIndex(
+        data->hasTokens() && data->isTokensComplete() ?
+        QBracketIndex(text, *data)
+        :
+        QBracketIndex(text, context)
+    );
+
+    QBracketSummary::invalidateBlock(currentBlock());
+
+    emit blockHighlighted(currentBlock().blockNumber());
+}
+
+void QStyleSyntaxHighlighter::applyFormats(const QVector<QHighlightContext::Range>& ranges)
+{
+    if (m_syntaxStyle == nullptr)
+    {
+        return;
+    }
+
+    for (auto&& range : ranges)
+    {
+        setFormat(
+            range.start,
+            range.length,
+            m_syntaxStyle->getFormat(range.formatId)
+        );
+    }
+}
+
+void QStyleSyntaxHighlighter::addStatistics(const QString& text,
+                                            const QHighlightContext& context,
+                                            qint64 nanoseconds,
+                                            bool cascade)
+{
+    auto blockNumber = currentBlock().blockNumber();
+
+    m_statistics.addBlock(
+        blockNumber,
+        text.size(),
+        nanoseconds,
+        context,
+        cascade
+    );
+
+    // State of current block isn't replaced yet
+    m_lastHighlightedBlock = blockNumber;
+    m_lastStateChanged = context.currentBlockState() != currentBlockState();
+}
+
+void QStyleSyntaxHighlighter::applyTokens(const QHighlightBlockData& data)
+{
+    if (m_syntaxStyle == nullptr)
+    {
+        return;
+    }
+
+    for (int i = 0; i < data.tokenCount(); ++i)
+    {
+        auto& token = data.token(i);
+
+        setFormat(
+            token.start(),
+            token.length(),
+            m_syntaxStyle->getFormat(token.formatId())
+        );
+    }
+}
+
+void QStyleSyntaxHighlighter::deferCurrentBlock()
+{
+    // Lazy mode keeps range of pending blocks, so
+    // only existing data is marked. Block isn't
+    // visible, so its formats are not copied.
+    if (m_highlightMode == HighlightMode::Lazy)
+    {
+        auto data = QHighlightBlockData::get(currentBlock());
+
+        if (data != nullptr)
+        {
+            data->setStatus(QHighlightBlockData::Status::Deferred);
+            QBracketSummary::invalidateBlock(currentBlock());
+        }
+
+        return;
+    }
+
+    // Keeping previous formats instead of flashing
+    // plain text. Block state stays the same, so
+    // following blocks are not highlighted again.
+    auto layout = currentBlock().layout();
+
+    if (layout)
+    {
+        for (auto&& range : layout->formats())
+        {
+            setFormat(range.start, range.length, range.format);
+        }
+    }
+
+    setCurrentBlockStatus(QHighlightBlockData::Status::Deferred);
+
+    // Brackets of deferred block are found from its text
+    QBracketSummary::invalidateBlock(currentBlock());
+}
+
+void QStyleSyntaxHighlighter::clearBlockData()
+{
+    auto doc = document();
+
+    if (doc == nullptr)
+    {
+        return;
+    }
+
+    // Blocks without highlighter data are
+    // indexed from their text
+    for (auto block = doc->begin(); block.isValid(); block = block.next())
+    {
+        if (QHighlightBlockData::get(block) != nullptr)
+        {
+            block.setUserData(nullptr);
+        }
+    }
+
+    QBracketSummary::invalidateDocument(doc);
+}
+
+void QStyleSyntaxHighlighter::trackDocument(QTextDocument* document)
+{
+    if (m_trackedDocument == document)
+    {
+        return;
+    }
+
+    disconnect(m_documentConnection);
+
+    m_trackedDocument = document;
+    ++m_revision;
+    m_firstPendingBlock = 0;
+    m_lastPendingBlock = -1;
+    m_blockCount = m_trackedDocument ? m_trackedDocument->blockCount() : 0;
+
+    // New document is highlighted with current style
+    m_restyleBlock = -1;
+
+    m_tokenArena.reset();
+
+    if (m_trackedDocument)
+    {
+        m_tokenArena = QSharedPointer<QTokenArena>::create();
+
+        m_documentConnection = connect(
+            m_trackedDocument,
+            &QTextDocument::contentsChange,
+            this,
+            &QStyleSyntaxHighlighter::onContentsChange
+        );
+    }
+}
+
+void QStyleSyntaxHighlighter::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    if (!charsRemoved && !charsAdded)
+    {
+        return;
+    }
+
+    ++m_revision;
+
+    auto blockNumber = qMax(0, m_trackedDocument->findBlock(position).blockNumber());
+    auto blockCount = m_trackedDocument->blockCount();
+
+    // Added or removed blocks shift pending blocks
+    auto shift = blockCount - m_blockCount;
+
+    if (m_firstPendingBlock > blockNumber)
+    {
+        m_firstPendingBlock = qMax(blockNumber, m_firstPendingBlock + shift);
+    }
+
+    if (m_lastPendingBlock >= blockNumber)
+    {
+        m_lastPendingBlock = qMax(blockNumber, m_lastPendingBlock + shift);
+    }
+
+    m_blockCount = blockCount;
+
+    if (m_restyleBlock > blockNumber)
+    {
+        m_restyleBlock = blockNumber;
+    }
+
+    if (!m_reformatDetached)
+    {
+        return;
+    }
+
+    auto first = m_trackedDocument->findBlock(position);
+    auto end = m_trackedDocument->findBlock(position + charsAdded);
+
+    first = first.isValid() ? first : m_trackedDocument->lastBlock();
+    end = end.isValid() ? end : m_trackedDocument->lastBlock();
+
+    // Blocks between first and last changed blocks
+    // were inserted, so they have no data
+    for (auto&& block : {first, end})
+    {
+        auto data = QHighlightBlockData::get(block);
+
+        if (data != nullptr)
+        {
+            data->setStatus(QHighlightBlockData::Status::Deferred);
+            QBracketSummary::invalidateBlock(block);
+        }
+    }
+
+    addPendingBlocks(first.blockNumber(), end.blockNumber());
+
+    highlightVisibleBlocks();
+    scheduleIdleSlice();
+}
+
+void QStyleSyntaxHighlighter::detachReformatting()
+{
+    auto doc = document();
+
+    if (doc == nullptr ||
+        !m_grammar ||
+        m_reformatDetached)
+    {
+        return;
+    }
+
+    trackDocument(doc);
+
+    // QSyntaxHighlighter highlights every changed block, so
+    // its connection is dropped with tracking connection,
+    // that's connected again
+    disconnect(doc, &QTextDocument::contentsChange, this, nullptr);
+
+    m_documentConnection = connect(
+        doc,
+        &QTextDocument::contentsChange,
+        this,
+        &QStyleSyntaxHighlighter::onContentsChange
+    );
+
+    // Connection may be replaced, while document
+    // notifies about change, so this change isn't
+    // tracked. Callers mark all blocks as pending.
+    m_blockCount = doc->blockCount();
+    ++m_revision;
+
+    m_reformatDetached = true;
+
+    dropDelayedRehighlight();
+}
+
+void QStyleSyntaxHighlighter::attachReformatting()
+{
+    if (!m_reformatDetached)
+    {
+        return;
+    }
+
+    m_reformatDetached = false;
+
+    // Contents change is tracked first, because
+    // tracking connection is still connected
+    QSyntaxHighlighter::setDocument(document());
+
+    dropDelayedRehighlight();
+}
+
+void QStyleSyntaxHighlighter::dropDelayedRehighlight()
+{
+    // Results of running job are posted too
+    auto jobScheduled = m_jobScheduled || m_jobRunning;
+    auto idleSliceScheduled = m_idleSliceScheduled;
+    auto restyleSliceScheduled = m_restyleSliceScheduled;
+
+    cancelJob();
+
+    // QSyntaxHighlighter posts highlighting of whole
+    // document to event loop, when document is attached.
+    // Calls, that highlighter posted itself, are
+    // posted again.
+    QCoreApplication::removePostedEvents(this, QEvent::MetaCall);
+
+    m_jobScheduled = false;
+    m_idleSliceScheduled = false;
+    m_restyleSliceScheduled = false;
+
+    if (jobScheduled)
+    {
+        scheduleJob();
+    }
+
+    if (idleSliceScheduled)
+    {
+        scheduleIdleSlice();
+    }
+
+    if (restyleSliceScheduled)
+    {
+        scheduleRestyleSlice();
+    }
+}
+
+void QStyleSyntaxHighlighter::highlightVisibleBlocks()
+{
+    if (m_highlightMode == HighlightMode::Synchronous ||
+        document() == nullptr ||
+        !m_grammar)
+    {
+        return;
+    }
+
+    // Blocks, that were scrolled into view, can't wait
+    // for background job or idle time. Blocks without
+    // data were inserted in lazy mode.
+    auto number = qMax(0, m_firstVisibleBlock - visibleBlocksMargin);
+    auto block = document()->findBlockByNumber(number);
+    for (;
+         block.isValid() && number <= m_lastVisibleBlock + visibleBlocksMargin;
+         block = block.next(), ++number)
+    {
+        auto data = QHighlightBlockData::get(block);
+
+        if (data == nullptr ||
+            data->status() == QHighlightBlockData::Status::Deferred ||
+            data->highlightRevision() != m_highlightRevision)
+        {
+            rehighlightBlock(block);
+        }
+        else if (!data->isFormatted())
+        {
+            restyleBlock(block);
+        }
+    }
+}
+
+bool QStyleSyntaxHighlighter::isBlockVisible(int blockNumber) const
+{
+    return blockNumber >= m_firstVisibleBlock - visibleBlocksMargin &&
+           blockNumber <= m_lastVisibleBlock + visibleBlocksMargin;
+}
+
+bool QStyleSyntaxHighlighter::isCurrentBlockFormatted() const
+{
+    auto layout = currentBlock().layout();
+
+    // Formats, that were applied before, are
+    // cleared, unless they are replaced
+    return layout != nullptr &&
+           !layout->formats().isEmpty();
+}
+
+bool QStyleSyntaxHighlighter::isPreviousBlockPending() const
+{
+    auto previous = currentBlock().previous();
+
+    return previous.isValid() &&
+           isBlockPending(previous);
+}
+
+bool QStyleSyntaxHighlighter::isBlockPending(const QTextBlock& block) const
+{
+    auto data = QHighlightBlockData::get(block);
+
+    // Blocks without data were inserted in lazy mode
+    return data == nullptr ||
+           data->isPending() ||
+           data->highlightRevision() != m_highlightRevision;
+}
+
+QHighlightBlockData* QStyleSyntaxHighlighter::currentBlockData()
+{
+    auto data = dynamic_cast<QHighlightBlockData*>(currentBlockUserData());
+
+    if (data == nullptr)
+    {
+        data = new QHighlightBlockData();
+        setCurrentBlockUserData(data);
+    }
+
+    return data;
+}
+
+void QStyleSyntaxHighlighter::setCurrentBlockStatus(QHighlightBlockData::Status status)
+{
+    currentBlockData()->setStatus(status);
+}
+
+void QStyleSyntaxHighlighter::scheduleJob()
+{
+    if (m_jobScheduled)
+    {
+        return;
+    }
+
+    m_jobScheduled = true;
+    QTimer::singleShot(0, this, &QStyleSyntaxHighlighter::startJob);
+}
+
+void QStyleSyntaxHighlighter::startJob()
+{
+    m_jobScheduled = false;
+
+    cancelJob();
+
+    auto doc = document();
+
+    if (doc == nullptr ||
+        !m_grammar ||
+        m_highlightMode != HighlightMode::Asynchronous)
+    {
+        return;
+    }
+
+    trackDocument(document());
+
+    // Highlighted blocks at ends of pending
+    // range are dropped from it
+    auto firstPendingNumber = m_firstPendingBlock;
+    auto lastPendingNumber = qMin(m_lastPendingBlock, doc->blockCount() - 1);
+
+    auto firstPending = doc->findBlockByNumber(firstPendingNumber);
+    while (firstPending.isValid() &&
+           firstPendingNumber <= lastPendingNumber &&
+           !isBlockPending(firstPending))
+    {
+        firstPending = firstPending.next();
+        ++firstPendingNumber;
+    }
+
+    if (!firstPending.isValid() ||
+        firstPendingNumber > lastPendingNumber)
+    {
+        m_firstPendingBlock = 0;
+        m_lastPendingBlock = -1;
+        return;
+    }
+
+    auto lastPending = doc->findBlockByNumber(lastPendingNumber);
+    while (lastPendingNumber > firstPendingNumber &&
+           !isBlockPending(lastPending))
+    {
+        lastPending = lastPending.previous();
+        --lastPendingNumber;
+    }
+
+    m_firstPendingBlock = firstPendingNumber;
+    m_lastPendingBlock = lastPendingNumber;
+
+    // Taking snapshot of blocks text
+    QStringList texts;
+    QVector<int> states;
+
+    auto lastNumber = lastPendingNumber + jobConvergenceBlocks;
+    auto block = firstPending;
+    for (auto i = firstPendingNumber;
+         block.isValid() && i <= lastNumber;
+         block = block.next(), ++i)
+    {
+        texts.append(block.text());
+        states.append(block.userState());
+    }
+
+    m_jobRunning = true;
+    m_jobFirstBlock = firstPendingNumber;
+    m_jobLastBlock = firstPendingNumber + texts.size() - 1;
+
+    m_threadPool.start(new Job(
+        this,
+        m_grammar,
+        m_jobGeneration.loadAcquire(),
+        m_revision,
+        firstPendingNumber,
+        firstPending.previous().userState(),
+        texts,
+        states,
+        lastPendingNumber - firstPendingNumber,
+        m_instrumented
+    ));
+}
+
+void QStyleSyntaxHighlighter::cancelJob()
+{
+    m_jobGeneration.fetchAndAddOrdered(1);
+    m_jobRunning = false;
+}
+
+void QStyleSyntaxHighlighter::applyResults(int generation,
+                                           int revision,
+                                           bool finished,
+                                           const QVector<BlockResult>& results)
+{
+    // Job was cancelled
+    if (generation != m_jobGeneration.loadAcquire())
+    {
+        return;
+    }
+
+    trackDocument(document());
+
+    auto doc = document();
+
+    if (doc == nullptr ||
+        revision != m_revision)
+    {
+        // Document was changed, results are stale
+        cancelJob();
+        scheduleJob();
+        return;
+    }
+
+    for (auto&& result : results)
+    {
+        m_results.insert(result.blockNumber, result);
+    }
+
+    m_applyingResults = true;
+
+    for (auto&& result : results)
+    {
+        // Block may be already highlighted, if state
+        // of previous block was changed
+        if (!m_results.contains(result.blockNumber))
+        {
+            continue;
+        }
+
+        rehighlightBlock(doc->findBlockByNumber(result.blockNumber));
+    }
+
+    m_applyingResults = false;
+    m_results.clear();
+
+    if (finished)
+    {
+        m_jobRunning = false;
+
+        // Checking for blocks, that were deferred out
+        // of job range
+        scheduleJob();
+    }
+}
+
+void QStyleSyntaxHighlighter::scheduleIdleSlice()
+{
+    if (m_idleSliceScheduled ||
+        m_processingIdleSlice)
+    {
+        return;
+    }
+
+    m_idleSliceScheduled = true;
+    QTimer::singleShot(0, this, &QStyleSyntaxHighlighter::processIdleSlice);
+}
+
+void QStyleSyntaxHighlighter::processIdleSlice()
+{
+    m_idleSliceScheduled = false;
+
+    auto doc = document();
+
+    if (doc == nullptr ||
+        !m_grammar ||
+        m_highlightMode != HighlightMode::Lazy)
+    {
+        return;
+    }
+
+    trackDocument(document());
+
+    m_processingIdleSlice = true;
+    m_idleSliceTimer.start();
+
+    // Blocks are highlighted in document order, so state
+    // of previous block is always actual. Highlighting of
+    // block with changed state continues to next blocks
+    // until slice is over.
+    auto number = m_firstPendingBlock;
+    auto block = doc->findBlockByNumber(number);
+    while (block.isValid() &&
+           number <= m_lastPendingBlock &&
+           m_idleSliceTimer.elapsed() < idleSliceMilliseconds)
+    {
+        if (isBlockPending(block))
+        {
+            rehighlightBlock(block);
+
+            // Block was not highlighted, slice is over
+            if (isBlockPending(block))
+            {
+                break;
+            }
+        }
+
+        block = block.next();
+        ++number;
+    }
+
+    m_processingIdleSlice = false;
+
+    if (block.isValid() &&
+        number <= m_lastPendingBlock)
+    {
+        m_firstPendingBlock = number;
+        scheduleIdleSlice();
+    }
+    else
+    {
+        m_firstPendingBlock = 0;
+        m_lastPendingBlock = -1;
+    }
+}
+
+void QStyleSyntaxHighlighter::addPendingBlocks(int firstBlock, int lastBlock)
+{
+    if (m_firstPendingBlock > m_lastPendingBlock)
+    {
+        m_firstPendingBlock = firstBlock;
+        m_lastPendingBlock = lastBlock;
+        return;
+    }
+
+    m_firstPendingBlock = qMax(0, qMin(m_firstPendingBlock, firstBlock));
+    m_lastPendingBlock = qMax(m_lastPendingBlock, lastBlock);
+}
+
+void QStyleSyntaxHighlighter::restyleBlock(const QTextBlock& block)
+{
+    auto data = QHighlightBlockData::get(block);
+
+    // Block without tokens was never highlighted
+    // by grammar, so it has no formats to replace
+    if (data == nullptr ||
+        !data->hasTokens())
+    {
+        return;
+    }
+
+    // Block out of visible range keeps no formats
+    if (!data->isFormatted() &&
+        !m_offscreenFormatting &&
+        m_highlightMode != HighlightMode::Synchronous &&
+        !isBlockVisible(block.blockNumber()))
+    {
+        return;
+    }
+
+    m_restyling = true;
+    rehighlightBlock(block);
+    m_restyling = false;
+}
+
+void QStyleSyntaxHighlighter::scheduleRestyleSlice()
+{
+    if (m_restyleSliceScheduled)
+    {
+        return;
+    }
+
+    m_restyleSliceScheduled = true;
+    QTimer::singleShot(0, this, &QStyleSyntaxHighlighter::processRestyleSlice);
+}
+
+void QStyleSyntaxHighlighter::processRestyleSlice()
+{
+    m_restyleSliceScheduled = false;
+
+    auto doc = document();
+
+    if (doc == nullptr ||
+        m_restyleBlock < 0)
+    {
+        return;
+    }
+
+    trackDocument(document());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto first = m_restyleBlock;
+    auto block = doc->findBlockByNumber(first);
+    while (block.isValid() &&
+           timer.elapsed() < idleSliceMilliseconds)
+    {
+        restyleBlock(block);
+        block = block.next();
+    }
+
+    emit blocksRestyled(
+        first,
+        block.isValid() ? block.blockNumber() - 1 : doc->blockCount() - 1
+    );
+
+    if (block.isValid())
+    {
+        m_restyleBlock = block.blockNumber();
+        scheduleRestyleSlice();
+    }
+    else
+    {
+        m_restyleBlock = -1;
+    }
+}
@@ -0,0 +1,67 @@
+// QCodeEditor
+#include <QSyntaxGrammar>
+
+// Qt
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWeakPointer>
+
+namespace
+{
+    /**
+     * @brief Structure, that describes registry
+     * of shared grammars. Registry doesn't own
+     * grammars, so unused grammars are freed.
+     */
+    struct GrammarRegistry
+    {
+        QMutex mutex;
+        QHash<QString, QWeakPointer<const QSyntaxGrammar>> grammars;
+    };
+
+    GrammarRegistry& grammarRegistry()
+    {
+        static GrammarRegistry registry;
+        return registry;
+    }
+}
+
+QSharedPointer<const QSyntaxGrammar> QSyntaxGrammar::shared(const QString& name, Factory factory)
+{
+    auto& registry = grammarRegistry();
+
+    {
+        QMutexLocker locker(&registry.mutex);
+
+        auto grammar = registry.grammars.value(name).toStrongRef();
+
+        if (grammar)
+        {
+            return grammar;
+        }
+    }
+
+    // Grammar is created without lock, because
+    // compiling may take a while
+    QSharedPointer<const QSyntaxGrammar> created(factory());
+
+    if (!created)
+    {
+        return created;
+    }
+
+    QMutexLocker locker(&registry.mutex);
+
+    // Other thread may have created grammar already
+    auto grammar = registry.grammars.value(name).toStrongRef();
+
+    if (grammar)
+    {
+        return grammar;
+    }
+
+    registry.grammars.insert(name, created);
+
+    return created;
+}
@@ -5,11 +5,15 @@
 #include <QDebug>
 #include <QXmlStreamReader>
 #include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
 
 QSyntaxStyle::QSyntaxStyle(QObject* parent) :
     QObject(parent),
     m_name(),
     m_data(),
+    m_formats(),
     m_loaded(false)
 {
 
@@ -109,8 +113,24 @@ bool QSyntaxStyle::load(QString fl)
         }
     }
 
+    // Resolving formats for every property of style
+    m_formats.clear();
+    for (auto it = m_data.begin(); it != m_data.end(); ++it)
+    {
+        auto id = formatId(it.key());
+
+        if (id >= m_formats.size())
+        {
+            m_formats.resize(id + 1);
+        }
+
+        m_formats[id] = it.value();
+    }
+
     m_loaded = !reader.hasError();
 
+    emit changed();
+
     return m_loaded;
 }
 
@@ -131,6 +151,72 @@ QTextCharFormat QSyntaxStyle::getFormat(QString name) const
     return result.value();
 }
 
+const QTextCharFormat& QSyntaxStyle::getFormat(int id) const
+{
+    static const QTextCharFormat empty;
+
+    // Ids, registered after style was loaded, are
+    // not properties of this style
+    if (id < 0 || id >= m_formats.size())
+    {
+        return empty;
+    }
+
+    return m_formats[id];
+}
+
+const QVector<QTextCharFormat>& QSyntaxStyle::formats() const
+{
+    return m_formats;
+}
+
+namespace
+{
+    /**
+     * @brief Structure, that describes registry
+     * of format ids.
+     */
+    struct FormatRegistry
+    {
+        QMutex mutex;
+        QHash<QString, int> ids;
+        QStringList names;
+    };
+
+    FormatRegistry& formatRegistry()
+    {
+        static FormatRegistry registry;
+        return registry;
+    }
+}
+
+int QSyntaxStyle::formatId(const QString& name)
+{
+    auto& registry = formatRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    auto result = registry.ids.find(name);
+
+    if (result != registry.ids.end())
+    {
+        return result.value();
+    }
+
+    auto id = registry.names.size();
+    registry.names.append(name);
+    registry.ids.insert(name, id);
+
+    return id;
+}
+
+QString QSyntaxStyle::formatName(int id)
+{
+    auto& registry = formatRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    return registry.names.value(id);
+}
+
 bool QSyntaxStyle::isLoaded() const
 {
     return m_loaded;
@@ -0,0 +1,96 @@
+// QCodeEditor
+#include <QTokenArena>
+
+QTokenArena::QTokenArena() :
+    m_chunks(),
+    m_chunkFree(0),
+    m_freeLists(),
+    m_reservedBytes(0),
+    m_usedBytes(0)
+{
+
+}
+
+QTokenArena::~QTokenArena()
+{
+    for (auto chunk : m_chunks)
+    {
+        delete[] chunk;
+    }
+}
+
+QTokenArena::Token* QTokenArena::allocate(int count, int& capacity)
+{
+    capacity = minCapacity;
+    int sizeClass = 0;
+
+    while (capacity < count)
+    {
+        capacity *= 2;
+        ++sizeClass;
+    }
+
+    m_usedBytes += capacity * sizeof(Token);
+
+    // Arrays, bigger than chunk, are allocated separately
+    if (sizeClass >= sizeClassCount)
+    {
+        m_reservedBytes += capacity * sizeof(Token);
+        return new Token[capacity];
+    }
+
+    auto& freeList = m_freeLists[sizeClass];
+
+    if (!freeList.isEmpty())
+    {
+        return freeList.takeLast();
+    }
+
+    // Rest of chunk is left unused
+    if (m_chunkFree < capacity)
+    {
+        m_chunks.append(new Token[chunkTokens]);
+        m_chunkFree = chunkTokens;
+        m_reservedBytes += chunkTokens * sizeof(Token);
+    }
+
+    auto tokens = m_chunks.last() + (chunkTokens - m_chunkFree);
+    m_chunkFree -= capacity;
+
+    return tokens;
+}
+
+void QTokenArena::release(Token* tokens, int capacity)
+{
+    if (tokens == nullptr)
+    {
+        return;
+    }
+
+    m_usedBytes -= capacity * sizeof(Token);
+
+    int sizeClass = 0;
+    for (auto size = minCapacity; size < capacity; size *= 2)
+    {
+        ++sizeClass;
+    }
+
+    if (sizeClass >= sizeClassCount)
+    {
+        m_reservedBytes -= capacity * sizeof(Token);
+        delete[] tokens;
+        return;
+    }
+
+    m_freeLists[sizeClass].append(tokens);
+}
+
+qint64 QTokenArena::reservedBytes() const
+{
+    return m_reservedBytes;
+}
+
+qint64 QTokenArena::usedBytes() const
+{
+    return m_usedBytes;
+}
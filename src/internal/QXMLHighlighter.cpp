@@ -1,111 +1,307 @@
 // QCodeEditor
 #include <QXMLHighlighter>
+#include <QSyntaxGrammar>
+#include <QHighlightContext>
 #include <QSyntaxStyle>
 
+// Qt
+#include <QString>
+
+/**
+ * @brief Class, that describes XML grammar. Block is
+ * tokenized in single pass. Construct, that's still
+ * open at the end of block, is stored in block state,
+ * so tags, attribute values, comments, CDATA sections
+ * and processing instructions may span lines.
+ */
+class QXMLHighlighter::Grammar : public QSyntaxGrammar
+{
+public:
+
+    Grammar();
+
+    void highlightBlock(const QString& text, QHighlightContext& context) const override;
+
+private:
+
+    /**
+     * @brief Enum, that describes open construct.
+     * Quote flags are combined with Tag,
+     * ProcessingInstruction and Declaration.
+     */
+    enum State
+    {
+        Text = 0,
+        Comment = 1,
+        CData = 2,
+        Tag = 3,
+        ProcessingInstruction = 4,
+        Declaration = 5,
+
+        ConstructMask = 0x7,
+
+        DoubleQuote = 0x8,
+        SingleQuote = 0x10
+    };
+
+    /**
+     * @brief Static method for checking if character
+     * can be part of element or attribute name.
+     */
+    static bool isNameCharacter(QChar character);
+
+    /**
+     * @brief Static method for getting end of name.
+     * @param text Block text.
+     * @param position Name start.
+     * @return Position after name.
+     */
+    static int nameEnd(const QString& text, int position);
+
+    int m_keywordFormat;
+    int m_textFormat;
+    int m_commentFormat;
+    int m_stringFormat;
+};
 
 QXMLHighlighter::QXMLHighlighter(QTextDocument* document) :
-    QStyleSyntaxHighlighter(document),
-    m_xmlKeywordRegexes   (),
-    m_xmlElementRegex     (R"(<[\s]*[/]?[\s]*([^\n][a-zA-Z-_:]*)(?=[\s/>]))"),
-    m_xmlAttributeRegex   (R"(\w+(?=\=))"),
-    m_xmlValueRegex       (R"("[^\n"]+"(?=\??[\s/>]))"),
-    m_xmlCommentBeginRegex(R"(<!--)"),
-    m_xmlCommentEndRegex  (R"(-->)")
+    QStyleSyntaxHighlighter(document)
 {
-    m_xmlKeywordRegexes
-        << QRegularExpression("<\\?")
-        << QRegularExpression("/>")
-        << QRegularExpression(">")
-        << QRegularExpression("<")
-        << QRegularExpression("</")
-        << QRegularExpression("\\?>");
+    setGrammar(QSyntaxGrammar::shared(
+        "XML",
+        []() -> QSyntaxGrammar* { return new Grammar(); }
+    ));
 }
 
-void QXMLHighlighter::highlightBlock(const QString& text)
+QXMLHighlighter::Grammar::Grammar() :
+    QSyntaxGrammar(),
+    m_keywordFormat(QSyntaxStyle::formatId("Keyword")),
+    m_textFormat(QSyntaxStyle::formatId("Text")),
+    m_commentFormat(QSyntaxStyle::formatId("Comment")),
+    m_stringFormat(QSyntaxStyle::formatId("String"))
 {
-    // Special treatment for xml element regex as we use captured text to emulate lookbehind
-    auto matchIterator = m_xmlElementRegex.globalMatch(text);
-    while (matchIterator.hasNext())
-    {
-        auto match = matchIterator.next();
 
-        setFormat(
-            match.capturedStart(),
-            match.capturedLength(),
-            syntaxStyle()->getFormat("Keyword") // XML ELEMENT FORMAT
-        );
-    }
+}
+
+void QXMLHighlighter::Grammar::highlightBlock(const QString& text, QHighlightContext& context) const
+{
+    static const QLatin1String commentBegin("<!--");
+    static const QLatin1String commentEnd("-->");
+    static const QLatin1String cdataBegin("<![CDATA[");
+    static const QLatin1String cdataEnd("]]>");
 
-    // Highlight xml keywords *after* xml elements to fix any occasional / captured into the enclosing element
+    auto state = qMax(context.previousBlockState(), 0);
+    auto length = text.size();
+    int position = 0;
 
-    for (auto&& regex : m_xmlKeywordRegexes)
+    while (position < length)
     {
-        highlightByRegex(
-            syntaxStyle()->getFormat("Keyword"),
-            regex,
-            text
-        );
-    }
+        // Attribute value
+        if (state & (DoubleQuote | SingleQuote))
+        {
+            auto quote = (state & DoubleQuote) ? '"' : '\'';
+            auto end = text.indexOf(QLatin1Char(quote), position);
 
-    highlightByRegex(
-        syntaxStyle()->getFormat("Text"),
-        m_xmlAttributeRegex,
-        text
-    );
+            if (end < 0)
+            {
+                context.setFormat(position, length - position, m_stringFormat);
+                break;
+            }
 
-    setCurrentBlockState(0);
+            context.setFormat(position, end + 1 - position, m_stringFormat);
+            position = end + 1;
+            state &= ConstructMask;
+            continue;
+        }
 
-    int startIndex = 0;
-    if (previousBlockState() != 1)
-    {
-        startIndex = text.indexOf(m_xmlCommentBeginRegex);
-    }
+        switch (state)
+        {
+        case Text:
+        {
+            position = text.indexOf(QLatin1Char('<'), position);
 
-    while (startIndex >= 0)
-    {
-        auto match = m_xmlCommentEndRegex.match(text, startIndex);
+            if (position < 0)
+            {
+                position = length;
+                break;
+            }
+
+            auto reference = text.midRef(position);
+
+            if (reference.startsWith(commentBegin))
+            {
+                context.setFormat(position, commentBegin.size(), m_commentFormat);
+                position += commentBegin.size();
+                state = Comment;
+                break;
+            }
 
-        int endIndex = match.capturedStart();
-        int commentLength = 0;
+            if (reference.startsWith(cdataBegin))
+            {
+                context.setFormat(position, cdataBegin.size(), m_keywordFormat);
+                position += cdataBegin.size();
+                state = CData;
+                break;
+            }
 
-        if (endIndex == -1)
+            // Markup start: "<", "</", "<?" or "<!"
+            auto start = position++;
+
+            if (position < length)
+            {
+                auto character = text[position];
+
+                if (character == '/')
+                {
+                    ++position;
+                    state = Tag;
+                }
+                else if (character == '?')
+                {
+                    ++position;
+                    state = ProcessingInstruction;
+                }
+                else if (character == '!')
+                {
+                    ++position;
+                    state = Declaration;
+                }
+                else
+                {
+                    state = Tag;
+                }
+            }
+            else
+            {
+                state = Tag;
+            }
+
+            // Element name, processing instruction
+            // target or declaration name
+            position = nameEnd(text, position);
+
+            context.setFormat(start, position - start, m_keywordFormat);
+            break;
+        }
+
+        case Comment:
         {
-            setCurrentBlockState(1);
-            commentLength = text.length() - startIndex;
+            auto end = text.indexOf(commentEnd, position);
+
+            if (end < 0)
+            {
+                context.setFormat(position, length - position, m_commentFormat);
+                position = length;
+                break;
+            }
+
+            end += commentEnd.size();
+
+            context.setFormat(position, end - position, m_commentFormat);
+            position = end;
+            state = Text;
+            break;
         }
-        else
+
+        case CData:
         {
-            commentLength = endIndex - startIndex + match.capturedLength();
+            auto end = text.indexOf(cdataEnd, position);
+
+            if (end < 0)
+            {
+                position = length;
+                break;
+            }
+
+            context.setFormat(end, cdataEnd.size(), m_keywordFormat);
+            position = end + cdataEnd.size();
+            state = Text;
+            break;
         }
 
-        setFormat(
-            startIndex,
-            commentLength,
-            syntaxStyle()->getFormat("Comment")
-        );
+        default:
+        {
+            auto character = text[position];
+
+            if (character == '"' || character == '\'')
+            {
+                context.setFormat(position, 1, m_stringFormat);
+                state |= character == '"' ? DoubleQuote : SingleQuote;
+                ++position;
+                break;
+            }
 
-        startIndex = text.indexOf(m_xmlCommentBeginRegex, startIndex + commentLength);
+            if (character == '>' && state != ProcessingInstruction)
+            {
+                context.setFormat(position, 1, m_keywordFormat);
+                ++position;
+                state = Text;
+                break;
+            }
+
+            if ((character == '/' && state == Tag) ||
+                (character == '?' && state == ProcessingInstruction))
+            {
+                if (position + 1 < length && text[position + 1] == '>')
+                {
+                    context.setFormat(position, 2, m_keywordFormat);
+                    position += 2;
+                    state = Text;
+                    break;
+                }
+            }
+
+            // Markup is not closed, new one starts
+            if (character == '<')
+            {
+                state = Text;
+                break;
+            }
+
+            if (isNameCharacter(character))
+            {
+                auto end = nameEnd(text, position);
+
+                // Attribute name
+                if (state != Declaration)
+                {
+                    context.setFormat(position, end - position, m_textFormat);
+                }
+
+                position = end;
+                break;
+            }
+
+            ++position;
+            break;
+        }
+        }
     }
 
-    highlightByRegex(
-        syntaxStyle()->getFormat("String"),
-        m_xmlValueRegex,
-        text
-    );
+    context.setCurrentBlockState(state);
 }
 
-void QXMLHighlighter::highlightByRegex(const QTextCharFormat& format, const QRegularExpression& regex, const QString& text)
+bool QXMLHighlighter::Grammar::isNameCharacter(QChar character)
 {
-    auto matchIterator = regex.globalMatch(text);
+    auto code = character.unicode();
 
-    while (matchIterator.hasNext())
-    {
-        auto match = matchIterator.next();
+    return (code >= 'a' && code <= 'z') ||
+           (code >= 'A' && code <= 'Z') ||
+           (code >= '0' && code <= '9') ||
+           code == '_' ||
+           code == '-' ||
+           code == ':' ||
+           code == '.' ||
+           code >= 0x80;
+}
 
-        setFormat(
-            match.capturedStart(),
-            match.capturedLength(),
-            format
-        );
+int QXMLHighlighter::Grammar::nameEnd(const QString& text, int position)
+{
+    while (position < text.size() &&
+           isNameCharacter(text[position]))
+    {
+        ++position;
     }
+
+    return position;
 }